@@ -6,3 +6,5 @@ class AchievementId : public ContentId<AchievementId> {
   public:
   using ContentId::ContentId;
 };
+
+CEREAL_CLASS_VERSION(AchievementId, 1)
@@ -7,3 +7,5 @@ class AttrType : public ContentId<AttrType> {
   public:
   using ContentId::ContentId;
 };
+
+CEREAL_CLASS_VERSION(AttrType, 1)
@@ -7,3 +7,5 @@ class BiomeId : public ContentId<BiomeId> {
   public:
   using ContentId::ContentId;
 };
+
+CEREAL_CLASS_VERSION(BiomeId, 1)
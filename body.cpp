@@ -880,6 +880,17 @@ bool Body::isIntrinsicallyAffected(LastingOrBuff l, const ContentFactory* factor
   return ret;
 }
 
+vector<LastingOrBuff> Body::getIntrinsicEffects(const ContentFactory* factory) const {
+  auto& material = factory->bodyMaterials.at(this->material);
+  if (material.intrinsicallyAffected.empty() && numGood(BodyPart::WING) < 2)
+    return {};
+  auto ret = material.intrinsicallyAffected.asVector();
+  if (numGood(BodyPart::WING) >= 2 && !material.intrinsicallyAffected.count(LastingEffect::FLYING))
+    ret.push_back(LastingEffect::FLYING);
+  std::sort(ret.begin(), ret.end());
+  return ret;
+}
+
 bool Body::isImmuneTo(LastingOrBuff l, const ContentFactory* factory) const {
   auto ret = factory->bodyMaterials.at(material).immuneTo.count(l);
   if (isOneOf(l, LastingEffect::RAGE, LastingEffect::PANIC, LastingEffect::TELEPATHY, LastingEffect::INSANITY))
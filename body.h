@@ -68,6 +68,8 @@ class Body {
   bool tick(const Creature*);
   bool heal(Creature*, double amount);
   bool isIntrinsicallyAffected(LastingOrBuff, const ContentFactory*) const;
+  // All effects for which isIntrinsicallyAffected() is true, lasting effects first.
+  vector<LastingOrBuff> getIntrinsicEffects(const ContentFactory*) const;
   bool isKilledByBoulder(const ContentFactory*) const;
   bool canWade() const;
   bool isFarmAnimal() const;
@@ -7,3 +7,5 @@ class BodyMaterialId : public ContentId<BodyMaterialId> {
   public:
   using ContentId::ContentId;
 };
+
+CEREAL_CLASS_VERSION(BodyMaterialId, 1)
@@ -7,3 +7,5 @@ class BuffId : public ContentId<BuffId> {
   public:
   using ContentId::ContentId;
 };
+
+CEREAL_CLASS_VERSION(BuffId, 1)
@@ -6,3 +6,5 @@ class BuildingId : public ContentId<BuildingId> {
   public:
   using ContentId::ContentId;
 };
+
+CEREAL_CLASS_VERSION(BuildingId, 1)
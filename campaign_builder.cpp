@@ -73,10 +73,10 @@ void CampaignBuilder::setPlayerPos(Campaign& campaign, Vec2 pos, ViewIdList play
 
 static Table<Campaign::SiteInfo> getTerrain(RandomGen& random, const ContentFactory* factory,
     RandomLayoutId worldMapId, Vec2 size) {
-  unordered_set<Token> allViewIds;
+  unordered_set<string> allViewIds;
   for (auto& def : factory->tilePaths.definitions)
     allViewIds.insert(def.viewId.data());
-  LayoutCanvas::Map map{Table<vector<Token>>(Rectangle(Vec2(0, 0), size))};
+  LayoutCanvas::Map map{Table<LayoutTile>(Rectangle(Vec2(0, 0), size))};
   LayoutCanvas canvas{map.elems.getBounds(), &map};
   bool generated = false;
   for (int i : Range(20))
@@ -87,7 +87,8 @@ static Table<Campaign::SiteInfo> getTerrain(RandomGen& random, const ContentFact
   CHECK(generated) << "Failed to generate world map";
   Table<Campaign::SiteInfo> ret(size, {});
   for (Vec2 v : ret.getBounds())
-    for (auto& token : map.elems[v]) {
+    for (auto elem : map.elems[v]) {
+      auto& token = elem.data();
       if (token == "blocked")
         ret[v].blocked = true;
       else if (allViewIds.count(token))
@@ -119,6 +119,8 @@ const heap_optional<CollectiveName>& Collective::getName() const {
 
 void Collective::setVillainType(VillainType t) {
   villainType = t;
+  for (auto& pos : territory->getAll())
+    pos.getModel()->updateTerritoryOwner(pos);
 }
 
 bool Collective::isDiscoverable() const {
@@ -628,7 +630,7 @@ void Collective::tick() {
   zones->tick();
   taskMap->tick();
   constructions->clearUnsupportedFurniturePlans();
-  dancing->setArea(zones->getPositions(ZoneId::LEISURE), getModel()->getLocalTime());
+  dancing->setArea(zones->getPositions(ZoneId::LEISURE).asPositionSet(), getModel()->getLocalTime());
   if (config->getWarnings() && Random.roll(5))
     warnings->considerWarnings(this);
   if (config->getEnemyPositions() && Random.roll(5)) {
@@ -764,6 +766,13 @@ bool Collective::creatureConsideredPlayer(Creature* c) const {
     (getGame()->getPlayerCollective() && getGame()->getPlayerCollective()->getCreatures().contains(c));
 }
 
+// Minions may die or get captured away from home.
+EventSubscription Collective::getEventSubscription() {
+  using namespace EventInfo;
+  return {getEventMask<Alarm, CreatureKilled, CreatureTortured, CreatureStunned,
+      TrapDisarmed, MovementChanged, FurnitureRemoved>(), true};
+}
+
 void Collective::onEvent(const GameEvent& event) {
   PROFILE;
   using namespace EventInfo;
@@ -953,6 +962,7 @@ void Collective::unclaimSquare(Position pos) {
   if (!territory->contains(pos))
     return;
   territory->remove(pos);
+  pos.getModel()->onTerritoryRemoved(this, pos);
   for (auto layer : {FurnitureLayer::FLOOR, FurnitureLayer::MIDDLE, FurnitureLayer::CEILING})
     if (auto furniture = pos.modFurniture(layer))
       if (constructions->containsFurniture(pos, layer)) {
@@ -964,6 +974,7 @@ void Collective::unclaimSquare(Position pos) {
 void Collective::claimSquare(Position pos, bool includeStairs) {
   //CHECK(canClaimSquare(pos));
   territory->insert(pos);
+  pos.getModel()->onTerritoryAdded(this, pos);
   addKnownTile(pos);
   for (auto layer : {FurnitureLayer::FLOOR, FurnitureLayer::MIDDLE, FurnitureLayer::CEILING})
     if (auto furniture = pos.modFurniture(layer))
@@ -1297,8 +1308,10 @@ void Collective::recalculateFurniturePopIncrease() {
 void Collective::onConstructed(Position pos, FurnitureType type) {
   if (pos.getFurniture(type)->forgetAfterBuilding()) {
     constructions->removeFurniturePlan(pos, getGame()->getContentFactory()->furniture.getData(type).getLayer());
-    if (territory->contains(pos))
+    if (territory->contains(pos)) {
       territory->remove(pos);
+      pos.getModel()->onTerritoryRemoved(this, pos);
+    }
     control->onConstructed(pos, type);
     return;
   }
@@ -1322,6 +1335,7 @@ void Collective::onDestructed(Position pos, FurnitureType type, const DestroyAct
       break;
     case DestroyAction::Type::DIG:
       territory->insert(pos);
+      pos.getModel()->onTerritoryAdded(this, pos);
       break;
     default:
       break;
@@ -223,6 +223,7 @@ class Collective : public TaskCallback, public UniqueEntity<Collective>, public
   bool isKnownVillainLocation(const Collective*) const;
 
   void onEvent(const GameEvent&);
+  static EventSubscription getEventSubscription();
 
   struct CurrentActivity {
     MinionActivity SERIAL(activity);
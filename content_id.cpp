@@ -119,30 +119,74 @@ std::ostream& operator <<(std::ostream& d, ContentId<T> id) {
 
 template <typename T>
 template <class Archive>
-void ContentId<T>::serialize(Archive& ar1, const unsigned int) {
+void ContentId<T>::serializeId(Archive& ar1, InternalId& id, const unsigned int) {
   if (Archive::is_loading::value) {
     string s;
     ar1(s);
     id = getId(s.data());
   } else {
-    string s = data();
+    string s = getAllIds()[id];
     ar1(s);
   }
 }
 
 template <typename T>
-template <class Archive>
-void PrimaryId<T>::serialize(Archive& ar1, const unsigned int) {
-  if (Archive::is_loading::value) {
-    string s;
-    ar1(s);
-    id = ContentId<T>::getId(s.data());
+static int getDictionaryTable() {
+  static const int table = SerialDictionary::getNewTable();
+  return table;
+}
+
+// Each id is written as a varint: 0 is followed by a string that is appended to the dictionary,
+// n > 0 refers to the (n - 1)-th dictionary entry.
+template <typename T>
+void ContentId<T>::serializeId(OutputArchive& ar1, InternalId& id, const unsigned int version) {
+  if (version == 0) {
+    serializeId<OutputArchive>(ar1, id, version);
+    return;
+  }
+  if (auto dictionary = SerialDictionary::get(&ar1))
+    if (auto index = dictionary->addOutput(getDictionaryTable<T>(), id)) {
+      saveVarInt(ar1, *index + 1);
+      return;
+    }
+  saveVarInt(ar1, 0);
+  string s = getAllIds()[id];
+  ar1(s);
+}
+
+template <typename T>
+void ContentId<T>::serializeId(InputArchive& ar1, InternalId& id, const unsigned int version) {
+  if (version == 0) {
+    serializeId<InputArchive>(ar1, id, version);
+    return;
+  }
+  auto dictionary = SerialDictionary::get(&ar1);
+  if (auto index = loadVarInt(ar1)) {
+    auto key = dictionary ? dictionary->getInput(getDictionaryTable<T>(), index - 1) : none;
+    if (!key)
+      throw ::cereal::Exception("Content id not found in the save file dictionary");
+    id = *key;
   } else {
-    string s = data();
+    string s;
     ar1(s);
+    id = getId(s.data());
+    if (dictionary)
+      dictionary->addInput(getDictionaryTable<T>(), id);
   }
 }
 
+template <typename T>
+template <class Archive>
+void ContentId<T>::serialize(Archive& ar1, const unsigned int version) {
+  serializeId(ar1, id, version);
+}
+
+template <typename T>
+template <class Archive>
+void PrimaryId<T>::serialize(Archive& ar1, const unsigned int version) {
+  ContentId<T>::serializeId(ar1, id, version);
+}
+
 template<typename T>
 PrimaryId<T>::PrimaryId(typename ContentId<T>::InternalId id) : id(id) {
 }
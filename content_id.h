@@ -32,10 +32,18 @@ class ContentId {
   InternalId id;
   static vector<string>& getAllIds();
   static int getId(const char* text);
+  template <class Archive>
+  static void serializeId(Archive&, InternalId&, const unsigned int version);
+  static void serializeId(InputArchive&, InternalId&, const unsigned int version);
+  static void serializeId(OutputArchive&, InternalId&, const unsigned int version);
 };
 
 void setInitializedStatics();
 
+// Resolves a content id from a literal only once per call site, instead of doing a string lookup
+// every time. Use on hot paths, e.g. STATIC_ID(FurnitureType, "BRIDGE").
+#define STATIC_ID(Type, text) ([] { static const Type id(text); return id; }())
+
 template <typename T>
 class PrimaryId {
   public:
@@ -75,3 +83,15 @@ HashMap<Key, Value> convertKeysHash(const map<PrimaryId<Key>, Value>& m) {
 
 template <typename T>
 std::ostream& operator <<(std::ostream&, ContentId<T>);
+
+// Version 1 writes ids through the archive's SerialDictionary instead of a full string every time.
+namespace cereal { namespace detail {
+template <typename T>
+struct Version<ContentId<T>> {
+  static const std::uint32_t version = 1;
+};
+template <typename T>
+struct Version<PrimaryId<T>> {
+  static const std::uint32_t version = 1;
+};
+}}
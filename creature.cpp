@@ -18,6 +18,7 @@
 #include "creature.h"
 #include "creature_factory.h"
 #include "level.h"
+#include "perception_cache.h"
 #include "item.h"
 #include "statistics.h"
 #include "options.h"
@@ -215,6 +216,7 @@ pair<CreatureAttributes, SpellMap> Creature::setAttributes(CreatureAttributes at
   modViewObject() = attributes->createViewObject();
   modViewObject().setGenericId(getUniqueId().getGenericId());
   modViewObject().setModifier(ViewObject::Modifier::CREATURE);
+  scheduleTimeouts();
   for (auto effect : ENUM_ALL(LastingEffect))
     if (attr.isAffectedPermanently(effect))
       LastingEffects::onAffected(this, effect, false);
@@ -275,7 +277,7 @@ void Creature::updateLastingFX(ViewObject& object, const ContentFactory* factory
   if (phylactery)
     object.particleEffects.insert(FXVariantName::LICH);
   if (auto time = getGlobalTime())
-    for (auto effect : ENUM_ALL(LastingEffect))
+    for (auto effect : getActiveLastingEffects())
       if (isAffected(effect, *time))
         if (auto fx = LastingEffects::getFX(effect))
           object.particleEffects.insert(*fx);
@@ -413,6 +415,8 @@ optional<MovementInfo> Creature::spendTime(TimeInterval t, SpeedModifier speedMo
       }
     }
     m->increaseMoveCounter();
+    if (hidden)
+      invalidatePerception();
     hidden = false;
     return ret;
   }
@@ -898,6 +902,7 @@ CreatureAction Creature::hide() const {
           }
         self->spendTime();
         self->hidden = true;
+        self->invalidatePerception();
       });
   return CreatureAction(TSentence("YOU_CANT_HIDE_HERE"));
 }
@@ -956,9 +961,12 @@ bool Creature::addEffect(LastingEffect effect, TimeInterval time, GlobalTime glo
     factory = getGame()->getContentFactory();
   if (LastingEffects::affects(this, effect, factory)) {
     bool was = isAffected(effect, globalTime);
-    if (!was || LastingEffects::canProlong(effect))
+    if (!was || LastingEffects::canProlong(effect)) {
       attributes->addLastingEffect(effect, globalTime + time);
+      scheduleTimeouts();
+    }
     if (!was && isAffected(effect, globalTime)) {
+      invalidatePerception();
       LastingEffects::onAffected(this, effect, msg);
       if (auto g = getGame())
         updateViewObject(g->getContentFactory());
@@ -975,6 +983,7 @@ bool Creature::removeEffect(LastingEffect effect, bool msg) {
   bool was = isAffected(effect);
   attributes->clearLastingEffect(effect);
   if (was && !isAffected(effect)) {
+    invalidatePerception();
     LastingEffects::onRemoved(this, effect, msg);
     if (auto g = getGame())
       updateViewObject(g->getContentFactory());
@@ -992,6 +1001,7 @@ bool Creature::addPermanentEffect(LastingEffect effect, int count, bool msg, con
     bool was = attributes->isAffectedPermanently(effect);
     attributes->addPermanentEffect(effect, count);
     if (!was && attributes->isAffectedPermanently(effect)) {
+      invalidatePerception();
       LastingEffects::onAffected(this, effect, msg);
       if (msg)
         message(PlayerMessage(TStringId("EFFECT_IS_PERMANENT"), MessagePriority::HIGH));
@@ -1008,6 +1018,7 @@ bool Creature::removePermanentEffect(LastingEffect effect, int count, bool msg)
   bool was = isAffected(effect);
   attributes->removePermanentEffect(effect, count);
   if (was && !isAffected(effect)) {
+    invalidatePerception();
     LastingEffects::onRemoved(this, effect, msg);
     if (auto g = getGame())
       updateViewObject(g->getContentFactory());
@@ -1059,14 +1070,17 @@ bool Creature::addEffect(BuffId id, TimeInterval time, GlobalTime global, const
     if (!info.stacks)
       for (auto& b : buffs)
         if (b.first == id) {
-          if (b.second < global + time)
+          if (b.second < global + time) {
             b.second = global + time;
+            scheduleTimeouts();
+          }
           return false;
         }
     return true;
   };
   if (add()) {
     buffs.push_back(make_pair(id, global + time));
+    scheduleTimeouts();
     if (++buffCount[id] == 1 || info.stacks) {
       if (msg && info.addedMessage)
         applyMessage(*info.addedMessage, this);
@@ -1312,6 +1326,7 @@ TribeId Creature::getTribeId() const {
 
 void Creature::setTribe(TribeId t) {
   tribe = t;
+  invalidatePerception();
 }
 
 bool Creature::isFriend(const Creature* c) const {
@@ -1404,10 +1419,6 @@ void Creature::tick() {
   }
   if (!!steed && isEnemy(steed.get()))
     tryToDismount();
-  const auto privateEnemyTimeout = 50_visible;
-  for (auto c : privateEnemies.getKeys())
-    if (privateEnemies.getOrFail(c) < *globalTime - privateEnemyTimeout)
-      privateEnemies.erase(c);
   considerMovingFromInaccessibleSquare();
   auto time = *getGlobalTime();
   vision->update(this, time);
@@ -1417,14 +1428,9 @@ void Creature::tick() {
   if (isDead())
     return;
   tickCompanions();
-  for (LastingEffect effect : ENUM_ALL(LastingEffect)) {
-    if (attributes->considerTimeout(effect, time))
-      LastingEffects::onTimedOut(this, effect, true);
-    if (isDead())
-      return;
+  for (LastingEffect effect : getActiveLastingEffects())
     if (isAffected(effect, time) && LastingEffects::tick(this, effect))
       return;
-  }
   if (processBuffs())
     return;
   updateViewObject(factory);
@@ -1438,29 +1444,104 @@ void Creature::tick() {
     position.addSound(*sound);
 }
 
+static const auto privateEnemyTimeout = 50_visible;
+
+vector<LastingEffect> Creature::getActiveLastingEffects() const {
+  auto& own = attributes->getActiveEffects();
+  if (!steed)
+    return own;
+  vector<LastingEffect> ret;
+  for (auto effect : own)
+    if (!LastingEffects::inheritsFromSteed(effect))
+      ret.push_back(effect);
+  for (auto effect : steed->attributes->getActiveEffects())
+    if (LastingEffects::inheritsFromSteed(effect))
+      ret.push_back(effect);
+  std::sort(ret.begin(), ret.end());
+  return ret;
+}
+
+optional<GlobalTime> Creature::getNextTimeout() const {
+  auto ret = attributes->getNextTimeout();
+  auto consider = [&ret] (GlobalTime time) {
+    if (!ret || time < *ret)
+      ret = time;
+  };
+  for (auto& buff : buffs)
+    consider(buff.second + 1_visible);
+  for (auto c : privateEnemies.getKeys())
+    consider(privateEnemies.getOrFail(c) + privateEnemyTimeout + 1_visible);
+  return ret;
+}
+
+void Creature::scheduleTimeouts(Model* model) {
+  scheduledTimeout = none;
+  if (auto time = getNextTimeout()) {
+    scheduledTimeout = *time;
+    model->addCreatureTimeout(this, *time);
+  }
+}
+
+void Creature::scheduleTimeouts() {
+  if (auto model = position.getModel())
+    if (auto time = getNextTimeout())
+      if (!scheduledTimeout || *time < *scheduledTimeout) {
+        scheduledTimeout = *time;
+        model->addCreatureTimeout(this, *time);
+      }
+}
+
+void Creature::processTimeouts(GlobalTime deadline) {
+  PROFILE;
+  if (scheduledTimeout != deadline)
+    return;
+  auto time = *getGlobalTime();
+  for (auto c : privateEnemies.getKeys())
+    if (privateEnemies.getOrFail(c) < time - privateEnemyTimeout)
+      privateEnemies.erase(c);
+  for (LastingEffect effect : copyOf(attributes->getActiveEffects()))
+    if (attributes->considerTimeout(effect, time)) {
+      invalidatePerception();
+      LastingEffects::onTimedOut(this, effect, true);
+      if (isDead())
+        return;
+    }
+  for (int index : All(buffs).reverse())
+    // Buff end effects might have removed other buffs.
+    if (index < buffs.size() && buffs[index].second < time) {
+      removeBuff(index, true);
+      if (isDead())
+        return;
+    }
+  if (auto model = position.getModel())
+    scheduleTimeouts(model);
+}
+
 bool Creature::processBuffs() {
   PROFILE
   auto factory = getGame()->getContentFactory();
   {
     PROFILE_BLOCK("intrinsic effects")
-    for (auto effect : ENUM_ALL(LastingEffect))
-      if (!attributes->isAffectedPermanently(effect) && getBody().isIntrinsicallyAffected(effect, factory))
-        addPermanentEffect(effect, 1, false);
-    for (auto effect : factory->buffs)
-      if (!isAffectedPermanently(effect.first) && getBody().isIntrinsicallyAffected(effect.first, factory))
-        addPermanentEffect(effect.first, 1, false);
+    for (auto& effect : getBody().getIntrinsicEffects(factory))
+      effect.visit(
+          [&](LastingEffect effect) {
+            if (!attributes->isAffectedPermanently(effect))
+              addPermanentEffect(effect, 1, false);
+          },
+          [&](BuffId effect) {
+            if (!isAffectedPermanently(effect))
+              addPermanentEffect(effect, 1, false);
+          }
+      );
   }
   auto buffsCopy = buffs;
-  auto time = *getGlobalTime();
   {
-    PROFILE_BLOCK("ticks and timeouts")
+    PROFILE_BLOCK("ticks")
     for (int index : All(buffsCopy).reverse()) {
       auto buff = buffsCopy[index];
       auto& info = factory->buffs.at(buff.first);
       if (info.tickEffect)
         info.tickEffect->applyToCreature(this, info.consideredBad ? lastAttacker : this);
-      if (buff.second < time)
-        removeBuff(index, true);
       if (isDead())
         return true;
     }
@@ -1539,6 +1620,7 @@ void Creature::tickCompanions() {
       for (auto c : companions[i].creatures) {
         c->setTribe(TribeId::getHostile());
         c->unknownAttackers.insert(this);
+        c->invalidatePerception();
       }
   }
 }
@@ -1679,12 +1761,18 @@ CreatureAction Creature::attack(Creature* other) const {
 }
 
 void Creature::onAttackedBy(Creature* attacker) {
-  if (!canSee(attacker))
+  if (!canSee(attacker)) {
     unknownAttackers.insert(attacker);
+    invalidatePerception();
+  }
   if (attacker->tribe != tribe && globalTime)
     // This attack may be accidental, so only do this for creatures from another tribe.
     // To handle intended attacks within one tribe, private enemy will be added in addCombatIntent
+  {
     privateEnemies.set(attacker, *globalTime);
+    scheduleTimeouts();
+    invalidatePerception();
+  }
   lastAttacker = attacker->getsCreditForKills();
   addCombatIntent(attacker, CombatIntentInfo::Type::ATTACK);
   if (hasAlternativeViewId())
@@ -1773,7 +1861,7 @@ bool Creature::takeDamage(const Attack& attack) {
     defense += getSpecialAttr(AttrType("DEFENSE"), attacker);
   }
   defense *= getFlankedMod();
-  for (LastingEffect effect : ENUM_ALL(LastingEffect))
+  for (LastingEffect effect : getActiveLastingEffects())
     if (isAffected(effect))
       defense = LastingEffects::modifyCreatureDefense(this, effect, defense, attack.damageType);
   auto factory = getGame()->getContentFactory();
@@ -1815,7 +1903,7 @@ bool Creature::takeDamage(const Attack& attack) {
     if (isDead())
       break;
   }
-  for (LastingEffect effect : ENUM_ALL(LastingEffect))
+  for (LastingEffect effect : getActiveLastingEffects())
     if (isAffected(effect))
       LastingEffects::afterCreatureDamage(this, effect);
   return returnValue;
@@ -2138,7 +2226,7 @@ CreatureAction Creature::torture(Creature* other) const {
 
 void Creature::retire() {
   unsubscribe();
-  for (LastingEffect effect : ENUM_ALL(LastingEffect))
+  for (LastingEffect effect : copyOf(attributes->getActiveEffects()))
     if (attributes->considerTimeout(effect, GlobalTime(1000000)))
       LastingEffects::onTimedOut(this, effect, false);
   spellMap->setAllReady();
@@ -2153,8 +2241,6 @@ void Creature::removeGameReferences() {
   nextPosIntent.reset();
   while (!controllerStack.empty())
     popController();
-  visibleEnemies.reset();
-  visibleCreatures.reset();
   lastCombatIntent.reset();
   gameCache = nullptr;
   companions.clear();
@@ -2805,10 +2891,9 @@ CreatureDebt& Creature::getDebt() {
   return *debt;
 }
 
-Creature::MoveId Creature::getCurrentMoveId() const {
-  if (auto model = position.getModel())
-    return {model->getMoveCounter(), model->getUniqueId()};
-  return {0, 0};
+void Creature::invalidatePerception() const {
+  if (auto level = position.getLevel())
+    level->getPerceptionCache().changed(position.getCoord());
 }
 
 const vector<Creature*>& Creature::getVisibleEnemies() const {
@@ -2821,10 +2906,13 @@ const vector<Creature*>& Creature::getVisibleEnemies() const {
       }
     return ret;
   };
-  auto currentMoveId = getCurrentMoveId();
-  if (!visibleEnemies || visibleEnemies->first != currentMoveId)
-    visibleEnemies.emplace(make_pair(currentMoveId, get()));
-  return visibleEnemies->second;
+  auto level = position.getLevel();
+  auto time = getGlobalTime();
+  if (!level || !time) {
+    static const vector<Creature*> empty;
+    return empty;
+  }
+  return level->getPerceptionCache().getVisibleEnemies(this, position.getCoord(), *time, get);
 }
 
 const vector<Creature*>& Creature::getVisibleCreatures() const {
@@ -2845,10 +2933,13 @@ const vector<Creature*>& Creature::getVisibleCreatures() const {
         }
     return ret;
   };
-  auto currentMoveId = getCurrentMoveId();
-  if (!visibleCreatures || visibleCreatures->first != currentMoveId)
-    visibleCreatures.emplace(make_pair(currentMoveId, get()));
-  return visibleCreatures->second;
+  auto level = position.getLevel();
+  auto time = getGlobalTime();
+  if (!level || !time) {
+    static const vector<Creature*> empty;
+    return empty;
+  }
+  return level->getPerceptionCache().getVisibleCreatures(this, position.getCoord(), *time, get);
 }
 
 bool Creature::shouldAIAttack(const Creature* other) const {
@@ -2975,8 +3066,11 @@ void Creature::addCombatIntent(Creature* attacker, CombatIntentInfo::Type type)
   if (attacker != this) {
     lastCombatIntent = CombatIntentInfo{type, attacker, *getGlobalTime()};
     if (globalTime && type == CombatIntentInfo::Type::ATTACK && (!attacker->isAffected(LastingEffect::INSANITY) ||
-        attacker->getAttributes().isAffectedPermanently(LastingEffect::INSANITY)))
+        attacker->getAttributes().isAffectedPermanently(LastingEffect::INSANITY))) {
       privateEnemies.set(attacker, *globalTime);
+      scheduleTimeouts();
+      invalidatePerception();
+    }
   }
 }
 
@@ -3043,6 +3137,12 @@ bool Creature::addButcheringEvent(const string& villageName) {
   return false;
 }
 
+// The phylactery may be in a different model than its owner.
+EventSubscription Creature::getEventSubscription() {
+  using namespace EventInfo;
+  return {getEventMask<FurnitureRemoved>(), true};
+}
+
 #define CASE(VAR, ELEM, TYPE, ...) \
     case std::remove_reference<decltype(VAR)>::type::TYPE##Tag: {\
       auto ELEM = event.getReferenceMaybe<std::remove_reference<decltype(VAR)>::type::TYPE>();\
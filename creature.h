@@ -112,6 +112,11 @@ class Creature : public Renderable, public UniqueEntity<Creature>, public OwnedO
   bool canSee(Vec2) const;
   bool isEnemy(const Creature*) const;
   void tick();
+  // Processes lasting effect, buff and private enemy timeouts. Called by the model when the time
+  // registered with scheduleTimeouts() has passed. Deadlines that were rescheduled since are ignored.
+  void processTimeouts(GlobalTime deadline);
+  // Registers the timeouts with a model that the creature is being added to.
+  void scheduleTimeouts(Model*);
   void upgradeViewId(int level);
   ViewIdList getMaxViewIdUpgrade() const;
   ViewIdList getViewIdWithWeapon() const;
@@ -362,6 +367,7 @@ class Creature : public Renderable, public UniqueEntity<Creature>, public OwnedO
   bool addButcheringEvent(const string& villageName);
 
   void onEvent(const GameEvent&);
+  static EventSubscription getEventSubscription();
 
   enum class SpeedModifier {
     SLOW,
@@ -407,10 +413,9 @@ class Creature : public Renderable, public UniqueEntity<Creature>, public OwnedO
   vector<KillInfo> SERIAL(kills);
   mutable int SERIAL(difficultyPoints) = 0;
   int SERIAL(points) = 0;
-  using MoveId = pair<int, LevelId>;
-  MoveId getCurrentMoveId() const;
-  mutable optional<pair<MoveId, vector<Creature*>>> visibleEnemies;
-  mutable optional<pair<MoveId, vector<Creature*>>> visibleCreatures;
+  // Marks the creature's square as changed in the level's perception cache, after a change that
+  // affects what it sees or who sees it.
+  void invalidatePerception() const;
   HeapAllocated<Vision> SERIAL(vision);
   bool forceMovement = false;
   void setForceMovement(bool value);
@@ -450,6 +455,12 @@ class Creature : public Renderable, public UniqueEntity<Creature>, public OwnedO
   vector<AdjectiveInfo> getLastingEffectAdjectives(const ContentFactory*, bool bad) const;
   bool removeBuff(int index, bool msg);
   bool processBuffs();
+  optional<GlobalTime> getNextTimeout() const;
+  void scheduleTimeouts();
+  // Effects that might be active on this creature, including the ones inherited from the steed.
+  // Returns a copy, as ticking an effect may add or remove others.
+  vector<LastingEffect> getActiveLastingEffects() const;
+  optional<GlobalTime> scheduledTimeout;
   double SERIAL(combatExperience) = 0;
   int SERIAL(maxPromotion) = 10000;
   double SERIAL(teamExperience) = 0;
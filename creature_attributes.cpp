@@ -36,6 +36,7 @@
 void CreatureAttributes::initializeLastingEffects() {
   for (LastingEffect effect : ENUM_ALL(LastingEffect))
     lastingEffects[effect] = GlobalTime(-500);
+  activeEffects = none;
 }
 
 void CreatureAttributes::randomize() {
@@ -70,6 +71,8 @@ void CreatureAttributes::serializeImpl(Archive& ar, const unsigned int version)
   ar(OPTION(cantEquip), OPTION(aiType), OPTION(canJoinCollective), OPTION(genderAlternatives), NAMED(promotionGroup));
   ar(OPTION(boulder), OPTION(noChase), OPTION(isSpecial), OPTION(spellSchools), OPTION(spells));
   ar(SKIP(permanentEffects), OPTION(lastingEffects), OPTION(minionActivities), OPTION(expLevel), OPTION(inventory));
+  if (Archive::is_loading::value)
+    activeEffects = none;
   ar(OPTION(noAttackSound), OPTION(maxLevelIncrease), NAMED(creatureId), NAMED(petReaction));
   ar(OPTION(automatonParts), OPTION(specialAttr), NAMED(deathEffect), NAMED(chatEffect), NAMED(petEffect), OPTION(companions));
   ar(OPTION(maxPromotions), OPTION(afterKilledSomeone), SKIP(permanentBuffs), OPTION(killedAchievement));
@@ -224,13 +227,14 @@ TString CreatureAttributes::getDescription(const ContentFactory* factory) const
 }
 
 void CreatureAttributes::add(BodyPart p, int count, const ContentFactory* factory) {
-  for (auto effect : ENUM_ALL(LastingEffect))
-    if (body->isIntrinsicallyAffected(effect, factory))
-      --permanentEffects[effect];
+  for (auto& effect : body->getIntrinsicEffects(factory))
+    if (auto lasting = effect.getValueMaybe<LastingEffect>())
+      --permanentEffects[*lasting];
   body->addWithoutUpdatingPermanentEffects(p, count);
-  for (auto effect : ENUM_ALL(LastingEffect))
-    if (body->isIntrinsicallyAffected(effect, factory))
-      ++permanentEffects[effect];
+  for (auto& effect : body->getIntrinsicEffects(factory))
+    if (auto lasting = effect.getValueMaybe<LastingEffect>())
+      ++permanentEffects[*lasting];
+  activeEffects = none;
 }
 
 static TString getVerbalReaction(const TString& reaction, const Creature* me) {
@@ -283,6 +287,7 @@ GlobalTime CreatureAttributes::getTimeOut(LastingEffect effect) const {
 void CreatureAttributes::copyLastingEffects(const CreatureAttributes& attr) {
   lastingEffects = attr.lastingEffects;
   permanentEffects[LastingEffect::STEED] = attr.permanentEffects[LastingEffect::STEED];
+  activeEffects = none;
 }
 
 bool CreatureAttributes::considerTimeout(LastingEffect effect, GlobalTime current) {
@@ -294,9 +299,31 @@ bool CreatureAttributes::considerTimeout(LastingEffect effect, GlobalTime curren
   return false;
 }
 
+optional<GlobalTime> CreatureAttributes::getNextTimeout() const {
+  optional<GlobalTime> ret;
+  for (auto effect : ENUM_ALL(LastingEffect)) {
+    auto time = lastingEffects[effect];
+    if (time > GlobalTime(0) && (!ret || time < *ret))
+      ret = time;
+  }
+  return ret;
+}
+
+const vector<LastingEffect>& CreatureAttributes::getActiveEffects() const {
+  if (!activeEffects) {
+    activeEffects.emplace();
+    for (auto effect : ENUM_ALL(LastingEffect))
+      if (permanentEffects[effect] > 0 || lastingEffects[effect] > GlobalTime(0))
+        activeEffects->push_back(effect);
+  }
+  return *activeEffects;
+}
+
 void CreatureAttributes::addLastingEffect(LastingEffect effect, GlobalTime endTime) {
-  if (lastingEffects[effect] < endTime)
+  if (lastingEffects[effect] < endTime) {
     lastingEffects[effect] = endTime;
+    activeEffects = none;
+  }
 }
 
 static bool consumeProb() {
@@ -379,14 +406,17 @@ bool CreatureAttributes::isAffectedPermanently(LastingEffect effect) const {
 
 void CreatureAttributes::clearLastingEffect(LastingEffect effect) {
   lastingEffects[effect] = GlobalTime(0);
+  activeEffects = none;
 }
 
 void CreatureAttributes::addPermanentEffect(LastingEffect effect, int count) {
   permanentEffects[effect] += count;
+  activeEffects = none;
 }
 
 void CreatureAttributes::removePermanentEffect(LastingEffect effect, int count) {
   permanentEffects[effect] -= count;
+  activeEffects = none;
 }
 
 const MinionActivityMap& CreatureAttributes::getMinionActivities() const {
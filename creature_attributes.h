@@ -108,6 +108,10 @@ class CreatureAttributes {
   void addPermanentEffect(LastingEffect, int count);
   void removePermanentEffect(LastingEffect, int count);
   bool considerTimeout(LastingEffect, GlobalTime current);
+  optional<GlobalTime> getNextTimeout() const;
+  // Effects that have a permanent count or a timeout set, in enum order. Any effect that isAffected()
+  // can return true for is on this list, so per-turn code doesn't need to scan every LastingEffect.
+  const vector<LastingEffect>& getActiveEffects() const;
   void addLastingEffect(LastingEffect, GlobalTime endtime);
   optional<GlobalTime> getLastAffected(LastingEffect, GlobalTime currentGlobalTime) const;
   bool canSleep() const;
@@ -172,6 +176,7 @@ class CreatureAttributes {
   vector<SpellId> SERIAL(spells);
   EnumMap<LastingEffect, int> SERIAL(permanentEffects);
   EnumMap<LastingEffect, GlobalTime> SERIAL(lastingEffects);
+  mutable optional<vector<LastingEffect>> activeEffects;
   MinionActivityMap SERIAL(minionActivities);
   HashMap<AttrType, double> SERIAL(expLevel);
   HashMap<AttrType, int> SERIAL(maxLevelIncrease);
@@ -568,6 +568,11 @@ class ShopkeeperController : public Monster, public EventListener<ShopkeeperCont
       debtors.erase(from);
   }
 
+  static EventSubscription getEventSubscription() {
+    using namespace EventInfo;
+    return {getEventMask<ItemsAppeared, ItemsPickedUp, ItemsDropped>()};
+  }
+
   void onEvent(const GameEvent& event) {
     using namespace EventInfo;
     event.visit<void>(
@@ -6,3 +6,5 @@ class CreatureId : public ContentId<CreatureId> {
   public:
   using ContentId::ContentId;
 };
+
+CEREAL_CLASS_VERSION(CreatureId, 1)
@@ -9,3 +9,5 @@ class CustomItemId : public ContentId<CustomItemId> {
   using ContentId::ContentId;
   SItemAttributes getAttributes(const ContentFactory*) const;
 };
+
+CEREAL_CLASS_VERSION(CustomItemId, 1)
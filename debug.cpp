@@ -24,7 +24,9 @@ void fail() {
 }
 
 DebugOutput DebugOutput::toStream(std::ostream& o) {
-  return DebugOutput(o, [&] { o << "\n" << std::flush;});
+  DebugOutput ret(o, [&] { o << "\n" << std::flush;});
+  ret.plainStream = true;
+  return ret;
 }
 
 DebugOutput DebugOutput::toString(function<void (const string&)> callback) {
@@ -33,7 +35,7 @@ DebugOutput DebugOutput::toString(function<void (const string&)> callback) {
 }
 
 DebugOutput DebugOutput::crash() {
-  return DebugOutput(*(new stringstream()), [] { fail(); });
+  return DebugOutput(*(new stringstream()), [] { InfoLog.flush(); fail(); });
 }
 
 DebugOutput DebugOutput::exitProgram() {
@@ -48,7 +50,366 @@ DebugLog::Logger DebugLog::get() {
   return Logger(outputs);
 }
 
-DebugLog InfoLog;
+const std::vector<DebugOutput>& DebugLog::getOutputs() const {
+  return outputs;
+}
+
+static constexpr int bufferSize = 4096;
+
+struct AsyncLog::Buffer {
+  Record records[bufferSize];
+  // Written only by the thread that owns the buffer.
+  std::atomic<std::uint32_t> head = {0};
+  // Written only by the thread that drains the buffer.
+  std::atomic<std::uint32_t> tail = {0};
+  std::atomic<int>* numDropped;
+};
+
+
+AsyncLog::AsyncLog() : minLevel(LogLevel::VERBOSE), numDropped(0) {
+}
+
+AsyncLog::~AsyncLog() {
+  {
+    std::lock_guard<std::mutex> lock(wakeMutex);
+    done = true;
+  }
+  wake.notify_one();
+  if (thread.joinable())
+    thread.join();
+  drain();
+}
+
+void AsyncLog::addOutput(DebugOutput o) {
+  std::lock_guard<std::recursive_timed_mutex> lock(outputMutex);
+  outputs.addOutput(o);
+}
+
+void AsyncLog::setMinLevel(LogLevel level) {
+  minLevel = level;
+}
+
+// Gives the buffer back when its thread exits. Records that weren't drained yet stay in it, and the next thread
+// that takes the buffer appends after them.
+struct AsyncLog::BufferOwner {
+  AsyncLog* log = nullptr;
+  Buffer* buffer = nullptr;
+
+  ~BufferOwner() {
+    if (buffer) {
+      std::lock_guard<std::mutex> lock(log->buffersMutex);
+      log->freeBuffers.push_back(buffer);
+    }
+  }
+};
+
+AsyncLog::Buffer* AsyncLog::getThreadBuffer() {
+  static thread_local BufferOwner owner;
+  if (!owner.buffer) {
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    owner.log = this;
+    if (!freeBuffers.empty()) {
+      owner.buffer = freeBuffers.back();
+      freeBuffers.pop_back();
+    } else {
+      buffers.push_back(std::make_unique<Buffer>());
+      owner.buffer = buffers.back().get();
+      owner.buffer->numDropped = &numDropped;
+    }
+    if (!thread.joinable())
+      thread = std::thread([this] {
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        while (!done) {
+          wake.wait_for(lock, milliseconds(50));
+          lock.unlock();
+          drain();
+          lock.lock();
+        }
+      });
+  }
+  return owner.buffer;
+}
+
+AsyncLog::Logger AsyncLog::get(LogLevel, const char* file, int line) {
+  return Logger(getThreadBuffer(), file, line);
+}
+
+// The record is built on the stack and copied into the buffer at the end, so that values that log something
+// while being formatted don't break the record being built.
+AsyncLog::Logger::Logger(Buffer* b, const char* file, int line) : buffer(b) {
+  record.file = file;
+  record.line = line;
+  record.size = 0;
+  record.truncated = false;
+  record.time = std::chrono::steady_clock::now().time_since_epoch().count();
+}
+
+AsyncLog::Logger::Logger(Logger&& o) : buffer(o.buffer), record(o.record) {
+  o.buffer = nullptr;
+}
+
+AsyncLog::Logger::~Logger() {
+  if (!buffer)
+    return;
+  auto head = buffer->head.load(std::memory_order_relaxed);
+  if (head - buffer->tail.load(std::memory_order_acquire) >= bufferSize) {
+    ++*buffer->numDropped;
+    return;
+  }
+  memcpy(&buffer->records[head % bufferSize], &record, offsetof(Record, data) + record.size);
+  buffer->head.store(head + 1, std::memory_order_release);
+}
+
+enum LogValueTag : char { LOG_STRING, LOG_CHAR, LOG_BOOL, LOG_INT, LOG_UINT, LOG_DOUBLE };
+
+void AsyncLog::Logger::addRaw(char tag, const void* data, int size) {
+  const int capacity = sizeof(record.data);
+  if (record.truncated)
+    return;
+  int needed = 1 + (tag == LOG_STRING ? 2 : 0) + size;
+  if (record.size + needed > capacity) {
+    if (tag != LOG_STRING || record.size + 4 > capacity) {
+      record.truncated = true;
+      return;
+    }
+    size = capacity - record.size - 3;
+    record.truncated = true;
+  }
+  char* dst = record.data + record.size;
+  *dst++ = tag;
+  if (tag == LOG_STRING) {
+    std::uint16_t length = size;
+    memcpy(dst, &length, 2);
+    dst += 2;
+  }
+  memcpy(dst, data, size);
+  record.size = dst + size - record.data;
+}
+
+void AsyncLog::Logger::add(const char* s) {
+  addRaw(LOG_STRING, s, strlen(s));
+}
+
+void AsyncLog::Logger::add(const string& s) {
+  addRaw(LOG_STRING, s.data(), s.size());
+}
+
+void AsyncLog::Logger::add(char c) {
+  addRaw(LOG_CHAR, &c, 1);
+}
+
+void AsyncLog::Logger::add(signed char c) {
+  add(char(c));
+}
+
+void AsyncLog::Logger::add(unsigned char c) {
+  add(char(c));
+}
+
+void AsyncLog::Logger::add(bool b) {
+  addRaw(LOG_BOOL, &b, 1);
+}
+
+void AsyncLog::Logger::add(long long a) {
+  addRaw(LOG_INT, &a, sizeof(a));
+}
+
+void AsyncLog::Logger::add(int a) {
+  add((long long) a);
+}
+
+void AsyncLog::Logger::add(long a) {
+  add((long long) a);
+}
+
+void AsyncLog::Logger::add(unsigned long long a) {
+  addRaw(LOG_UINT, &a, sizeof(a));
+}
+
+void AsyncLog::Logger::add(unsigned a) {
+  add((unsigned long long) a);
+}
+
+void AsyncLog::Logger::add(unsigned long a) {
+  add((unsigned long long) a);
+}
+
+void AsyncLog::Logger::add(double a) {
+  addRaw(LOG_DOUBLE, &a, sizeof(a));
+}
+
+void AsyncLog::Logger::add(float a) {
+  add((double) a);
+}
+
+template <typename Stream>
+static void formatRecord(const AsyncLog::Record& record, Stream& os) {
+  os << record.file << ":" << record.line << " ";
+  const char* data = record.data;
+  const char* end = data + record.size;
+  auto read = [&data] (auto& value) {
+    memcpy(&value, data, sizeof(value));
+    data += sizeof(value);
+  };
+  while (data < end)
+    switch (*data++) {
+      case LOG_STRING: {
+        std::uint16_t length;
+        read(length);
+        os.write(data, length);
+        data += length;
+        break;
+      }
+      case LOG_CHAR: {
+        char c;
+        read(c);
+        os << c;
+        break;
+      }
+      case LOG_BOOL: {
+        bool b;
+        read(b);
+        os << b;
+        break;
+      }
+      case LOG_INT: {
+        long long a;
+        read(a);
+        os << a;
+        break;
+      }
+      case LOG_UINT: {
+        unsigned long long a;
+        read(a);
+        os << a;
+        break;
+      }
+      case LOG_DOUBLE: {
+        double a;
+        read(a);
+        os << a;
+        break;
+      }
+    }
+  if (record.truncated)
+    os << "...";
+}
+
+static string formatRecord(const AsyncLog::Record& record) {
+  std::ostringstream os;
+  formatRecord(record, os);
+  return os.str();
+}
+
+namespace {
+// Formats a line into a fixed array, for when the heap can't be used.
+class FixedLine {
+  public:
+  FixedLine& write(const char* s, int length) {
+    length = std::min<int>(length, sizeof(data) - size);
+    memcpy(data + size, s, length);
+    size += length;
+    return *this;
+  }
+
+  FixedLine& operator << (const char* s) {
+    return write(s, strlen(s));
+  }
+
+  FixedLine& operator << (char c) {
+    return write(&c, 1);
+  }
+
+  FixedLine& operator << (bool b) {
+    return *this << (b ? "1" : "0");
+  }
+
+  FixedLine& operator << (int a) {
+    return *this << (long long) a;
+  }
+
+  FixedLine& operator << (long long a) {
+    return print("%lld", a);
+  }
+
+  FixedLine& operator << (unsigned long long a) {
+    return print("%llu", a);
+  }
+
+  FixedLine& operator << (double a) {
+    return print("%g", a);
+  }
+
+  char data[512];
+  int size = 0;
+
+  private:
+  template <typename T>
+  FixedLine& print(const char* format, T value) {
+    char tmp[32];
+    int length = snprintf(tmp, sizeof(tmp), format, value);
+    return write(tmp, std::max(0, std::min<int>(length, sizeof(tmp) - 1)));
+  }
+};
+}
+
+void AsyncLog::drain() {
+  // A crash might have happened while the lock was taken on this or another thread.
+  std::unique_lock<std::recursive_timed_mutex> outputLock(outputMutex, std::defer_lock);
+  if (!outputLock.try_lock_for(milliseconds(1000)))
+    return;
+  vector<pair<std::int64_t, string>> lines;
+  {
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    for (auto& buffer : buffers) {
+      auto tail = buffer->tail.load(std::memory_order_relaxed);
+      auto head = buffer->head.load(std::memory_order_acquire);
+      for (; tail != head; ++tail) {
+        auto& record = buffer->records[tail % bufferSize];
+        lines.push_back(make_pair(record.time, formatRecord(record)));
+      }
+      buffer->tail.store(head, std::memory_order_release);
+    }
+  }
+  std::stable_sort(lines.begin(), lines.end(),
+      [](const auto& l1, const auto& l2) { return l1.first < l2.first; });
+  for (auto& line : lines)
+    outputs.get() << line.second;
+  int dropped = numDropped;
+  if (dropped > numDroppedReported) {
+    outputs.get() << "Log buffer full, dropped " << dropped - numDroppedReported << " messages";
+    numDroppedReported = dropped;
+  }
+}
+
+void AsyncLog::flush() {
+  drain();
+}
+
+void AsyncLog::flushOnCrash() {
+  std::unique_lock<std::recursive_timed_mutex> outputLock(outputMutex, std::try_to_lock);
+  std::unique_lock<std::mutex> buffersLock(buffersMutex, std::try_to_lock);
+  if (!outputLock.owns_lock() || !buffersLock.owns_lock())
+    return;
+  auto& streams = outputs.getOutputs();
+  for (auto& buffer : buffers) {
+    auto tail = buffer->tail.load(std::memory_order_relaxed);
+    auto head = buffer->head.load(std::memory_order_acquire);
+    for (; tail != head; ++tail) {
+      FixedLine line;
+      formatRecord(buffer->records[tail % bufferSize], line);
+      for (auto& output : streams)
+        if (output.plainStream)
+          output.out.write(line.data, line.size).put('\n');
+    }
+    buffer->tail.store(head, std::memory_order_release);
+  }
+  for (auto& output : streams)
+    if (output.plainStream)
+      output.out.flush();
+}
+
+AsyncLog InfoLog;
 DebugLog FatalLog;
 DebugLog UserInfoLog;
 DebugLog UserErrorLog;
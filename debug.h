@@ -17,11 +17,14 @@
 
 #include <vector>
 #include "stdafx.h"
+#include "profiler.h"
 
 #define FATAL FatalLog.get() << "FATAL " << __FILE__ << ":" << __LINE__ << " "
 #define USER_FATAL UserErrorLog.get()
 #define USER_INFO UserInfoLog.get()
-#define INFO InfoLog.get() << __FILE__ << ":" <<  __LINE__ << " "
+#define LOG(level) if (!InfoLog.isEnabled(level)) {} else InfoLog.get(level, __FILE__, __LINE__)
+#define INFO LOG(LogLevel::NORMAL)
+#define INFO_VERBOSE LOG(LogLevel::VERBOSE)
 #define CHECK(exp) if (!(exp)) FATAL << ": " << #exp << " is false. "
 #define USER_CHECK(exp) if (!(exp)) USER_FATAL
 //#define CHECKEQ(exp, exp2) if ((exp) != (exp2)) FATAL << __FILE__ << ":" << __LINE__ << ": " << #exp << " = " << #exp2 << " is false. " << exp << " " << exp2
@@ -30,17 +33,18 @@
 #ifndef WINDOWS
 
 #define MEASURE(exp, text) do { \
+  PROFILE_BLOCK(text) \
   timeval time1; \
   gettimeofday(&time1, nullptr); \
   suseconds_t m1 = time1.tv_usec + time1.tv_sec * 1000000; \
   exp; \
   gettimeofday(&time1, nullptr); \
   suseconds_t m2 = time1.tv_usec + time1.tv_sec * 1000000; \
-  INFO << text << " " << int(m2 - m1);} while(0);
+  INFO_VERBOSE << text << " " << int(m2 - m1);} while(0);
 
 #else
 
-#define MEASURE(exp, text) exp;
+#define MEASURE(exp, text) do { PROFILE_BLOCK(text) exp; } while(0);
 
 #endif
 
@@ -67,6 +71,8 @@ class DebugOutput {
   typedef function<void()> LineEndFun;
   std::ostream& out;
   LineEndFun onLineEnd;
+  // Outputs made by toStream() can still be written to when the program is crashing.
+  bool plainStream = false;
 
   private:
   DebugOutput(std::ostream& o, LineEndFun end) : out(o), onLineEnd(end) {}
@@ -96,12 +102,105 @@ class DebugLog {
   };
 
   Logger get();
+  const std::vector<DebugOutput>& getOutputs() const;
 
   private:
   std::vector<DebugOutput> outputs;
 };
 
-extern DebugLog InfoLog;
+enum class LogLevel { VERBOSE, NORMAL, NONE };
+
+// Log that doesn't format anything on the logging thread. Numbers and strings are copied into a ring buffer
+// owned by the thread, other values are formatted into strings first. A background thread turns the records
+// into lines and writes them to the outputs. Records that don't fit into a full buffer are dropped and counted.
+class AsyncLog {
+  public:
+  AsyncLog();
+  ~AsyncLog();
+
+  void addOutput(DebugOutput);
+  void setMinLevel(LogLevel);
+  bool isEnabled(LogLevel level) const {
+    return level >= minLevel.load(std::memory_order_relaxed);
+  }
+  // Writes out everything that was logged so far.
+  void flush();
+  // Like flush(), but safe to call from a crash signal handler. It doesn't wait for locks and doesn't allocate,
+  // so it writes only to plain stream outputs, and doesn't sort the lines of different threads by time.
+  void flushOnCrash();
+
+  // Values are stored as a tag followed by the raw bytes, strings are prefixed by their length.
+  struct Record {
+    const char* file;
+    int line;
+    std::uint16_t size;
+    bool truncated;
+    std::int64_t time;
+    char data[232];
+  };
+  struct Buffer;
+  struct BufferOwner;
+
+  class Logger {
+    public:
+    Logger(Buffer*, const char* file, int line);
+    Logger(Logger&&);
+    ~Logger();
+
+    template <typename T>
+    Logger& operator << (const T& t) {
+      if (buffer)
+        add(t);
+      return *this;
+    }
+
+    private:
+    void add(const char*);
+    void add(const string&);
+    void add(char);
+    void add(signed char);
+    void add(unsigned char);
+    void add(bool);
+    void add(int);
+    void add(long);
+    void add(long long);
+    void add(unsigned);
+    void add(unsigned long);
+    void add(unsigned long long);
+    void add(float);
+    void add(double);
+    template <typename T>
+    void add(const T& t) {
+      std::ostringstream os;
+      os << t;
+      add(os.str());
+    }
+    void addRaw(char tag, const void* data, int size);
+    Buffer* buffer;
+    Record record;
+  };
+
+  Logger get(LogLevel, const char* file, int line);
+
+  private:
+  Buffer* getThreadBuffer();
+  void drain();
+  std::atomic<LogLevel> minLevel;
+  std::mutex buffersMutex;
+  std::vector<std::unique_ptr<Buffer>> buffers;
+  // Buffers of threads that have exited, which will be given to new threads.
+  std::vector<Buffer*> freeBuffers;
+  std::recursive_timed_mutex outputMutex;
+  DebugLog outputs;
+  std::atomic<int> numDropped;
+  int numDroppedReported = 0;
+  std::mutex wakeMutex;
+  std::condition_variable wake;
+  bool done = false;
+  std::thread thread;
+};
+
+extern AsyncLog InfoLog;
 extern DebugLog FatalLog;
 extern DebugLog UserErrorLog;
 extern DebugLog UserInfoLog;
@@ -0,0 +1,278 @@
+#include "stdafx.h"
+#include "dense_position_set.h"
+#include "level.h"
+
+template <class Archive>
+void DensePositionSet::serialize(Archive& ar, const unsigned int) {
+  ar(levels, totalCount);
+}
+
+SERIALIZABLE(DensePositionSet)
+
+static int getLowestBit(std::uint64_t word) {
+#ifdef __GNUC__
+  return __builtin_ctzll(word);
+#else
+  int ret = 0;
+  while (!(word & 1)) {
+    word >>= 1;
+    ++ret;
+  }
+  return ret;
+#endif
+}
+
+static int countBits(std::uint64_t word) {
+#ifdef __GNUC__
+  return __builtin_popcountll(word);
+#else
+  int ret = 0;
+  for (; word; word &= word - 1)
+    ++ret;
+  return ret;
+#endif
+}
+
+DensePositionSet::DensePositionSet(const PositionSet& set) {
+  for (auto& pos : set)
+    insert(pos);
+}
+
+optional<pair<int, std::uint64_t>> DensePositionSet::LevelBits::getBit(Vec2 v) const {
+  v -= origin;
+  if (v.x < 0 || v.y < 0 || v.x >= width || v.y >= height)
+    return none;
+  return make_pair(v.y * wordsPerRow + v.x / 64, std::uint64_t(1) << (v.x % 64));
+}
+
+Vec2 DensePositionSet::LevelBits::getCoord(int wordIndex, int bit) const {
+  return origin + Vec2((wordIndex % wordsPerRow) * 64 + bit, wordIndex / wordsPerRow);
+}
+
+const DensePositionSet::LevelBits* DensePositionSet::getBits(const Level* level) const {
+  for (auto& bits : levels)
+    if (bits.level == level)
+      return &bits;
+  return nullptr;
+}
+
+DensePositionSet::LevelBits& DensePositionSet::getOrInitBits(Level* level) {
+  if (auto bits = getBits(level))
+    return const_cast<LevelBits&>(*bits);
+  auto bounds = level->getBounds();
+  LevelBits bits;
+  bits.level = level;
+  bits.origin = bounds.topLeft();
+  bits.width = bounds.width();
+  bits.height = bounds.height();
+  bits.wordsPerRow = (bits.width + 63) / 64;
+  bits.words = vector<std::uint64_t>(bits.wordsPerRow * bits.height, 0);
+  levels.push_back(std::move(bits));
+  return levels.back();
+}
+
+bool DensePositionSet::insert(Position pos) {
+  if (!pos.isValid())
+    return false;
+  auto& bits = getOrInitBits(pos.getLevel());
+  auto bit = bits.getBit(pos.getCoord());
+  if (!bit || (bits.words[bit->first] & bit->second))
+    return false;
+  bits.words[bit->first] |= bit->second;
+  ++bits.count;
+  ++totalCount;
+  return true;
+}
+
+bool DensePositionSet::erase(Position pos) {
+  if (auto bits = getBits(pos.getLevel()))
+    if (auto bit = bits->getBit(pos.getCoord()))
+      if (bits->words[bit->first] & bit->second) {
+        auto& mutableBits = const_cast<LevelBits&>(*bits);
+        mutableBits.words[bit->first] &= ~bit->second;
+        --mutableBits.count;
+        --totalCount;
+        return true;
+      }
+  return false;
+}
+
+bool DensePositionSet::contains(Position pos) const {
+  if (auto bits = getBits(pos.getLevel()))
+    if (auto bit = bits->getBit(pos.getCoord()))
+      return bits->words[bit->first] & bit->second;
+  return false;
+}
+
+int DensePositionSet::count(Position pos) const {
+  return contains(pos) ? 1 : 0;
+}
+
+int DensePositionSet::size() const {
+  return totalCount;
+}
+
+bool DensePositionSet::empty() const {
+  return totalCount == 0;
+}
+
+void DensePositionSet::clear() {
+  levels.clear();
+  totalCount = 0;
+}
+
+void DensePositionSet::limitToModel(const Model* model) {
+  for (int i : All(levels).reverse())
+    if (levels[i].level->getModel() != model) {
+      totalCount -= levels[i].count;
+      levels.removeIndexPreserveOrder(i);
+    }
+}
+
+void DensePositionSet::unionWith(const DensePositionSet& other) {
+  for (auto& otherBits : other.levels) {
+    auto& bits = getOrInitBits(otherBits.level);
+    totalCount -= bits.count;
+    bits.count = 0;
+    for (int i : All(bits.words)) {
+      bits.words[i] |= otherBits.words[i];
+      bits.count += countBits(bits.words[i]);
+    }
+    totalCount += bits.count;
+  }
+}
+
+void DensePositionSet::subtract(const DensePositionSet& other) {
+  for (auto& otherBits : other.levels)
+    if (auto bits = getBits(otherBits.level)) {
+      auto& mutableBits = const_cast<LevelBits&>(*bits);
+      totalCount -= mutableBits.count;
+      mutableBits.count = 0;
+      for (int i : All(mutableBits.words)) {
+        mutableBits.words[i] &= ~otherBits.words[i];
+        mutableBits.count += countBits(mutableBits.words[i]);
+      }
+      totalCount += mutableBits.count;
+    }
+}
+
+DensePositionSet DensePositionSet::withMargin() const {
+  DensePositionSet ret;
+  ret.levels = levels;
+  for (auto& bits : ret.levels) {
+    const int rowWords = bits.wordsPerRow;
+    auto lastWordMask = bits.width % 64 == 0 ? ~std::uint64_t(0) : (std::uint64_t(1) << (bits.width % 64)) - 1;
+    // Spread each row horizontally, carrying bits across word boundaries.
+    vector<std::uint64_t> horizontal(bits.words.size(), 0);
+    for (int y : Range(bits.height))
+      for (int x : Range(rowWords)) {
+        int index = y * rowWords + x;
+        auto word = bits.words[index];
+        auto spread = word | (word << 1) | (word >> 1);
+        if (x > 0)
+          spread |= bits.words[index - 1] >> 63;
+        if (x < rowWords - 1)
+          spread |= bits.words[index + 1] << 63;
+        else
+          spread &= lastWordMask;
+        horizontal[index] = spread;
+      }
+    // Then merge each row with its upper and lower neighbour.
+    bits.count = 0;
+    for (int y : Range(bits.height))
+      for (int x : Range(rowWords)) {
+        int index = y * rowWords + x;
+        auto word = horizontal[index];
+        if (y > 0)
+          word |= horizontal[index - rowWords];
+        if (y < bits.height - 1)
+          word |= horizontal[index + rowWords];
+        bits.words[index] = word;
+        bits.count += countBits(word);
+      }
+    ret.totalCount += bits.count;
+  }
+  return ret;
+}
+
+vector<Position> DensePositionSet::asVector() const {
+  vector<Position> ret;
+  ret.reserve(totalCount);
+  for (auto& pos : *this)
+    ret.push_back(pos);
+  return ret;
+}
+
+PositionSet DensePositionSet::asPositionSet() const {
+  PositionSet ret;
+  ret.reserve(totalCount);
+  for (auto& pos : *this)
+    ret.insert(pos);
+  return ret;
+}
+
+bool DensePositionSet::operator == (const DensePositionSet& other) const {
+  if (totalCount != other.totalCount)
+    return false;
+  for (auto& bits : levels)
+    if (bits.count > 0) {
+      auto otherBits = other.getBits(bits.level);
+      if (!otherBits || otherBits->count != bits.count || otherBits->words != bits.words)
+        return false;
+    }
+  return true;
+}
+
+bool DensePositionSet::operator != (const DensePositionSet& other) const {
+  return !(*this == other);
+}
+
+DensePositionSet::Iterator::Iterator(const DensePositionSet* set, int levelIndex)
+    : set(set), levelIndex(levelIndex) {
+  if (levelIndex < set->levels.size()) {
+    remaining = set->levels[levelIndex].words.empty() ? 0 : set->levels[levelIndex].words[0];
+    findNext();
+  }
+}
+
+void DensePositionSet::Iterator::findNext() {
+  while (levelIndex < set->levels.size()) {
+    auto& bits = set->levels[levelIndex];
+    while (!remaining && ++wordIndex < bits.words.size())
+      remaining = bits.words[wordIndex];
+    if (remaining) {
+      current = Position(bits.getCoord(wordIndex, getLowestBit(remaining)), bits.level, Position::IsValid{});
+      return;
+    }
+    ++levelIndex;
+    wordIndex = 0;
+    if (levelIndex < set->levels.size() && !set->levels[levelIndex].words.empty())
+      remaining = set->levels[levelIndex].words[0];
+  }
+}
+
+const Position& DensePositionSet::Iterator::operator* () const {
+  return current;
+}
+
+const Position* DensePositionSet::Iterator::operator-> () const {
+  return &current;
+}
+
+DensePositionSet::Iterator& DensePositionSet::Iterator::operator++ () {
+  remaining &= remaining - 1;
+  findNext();
+  return *this;
+}
+
+bool DensePositionSet::Iterator::operator != (const Iterator& other) const {
+  return levelIndex != other.levelIndex || wordIndex != other.wordIndex || remaining != other.remaining;
+}
+
+DensePositionSet::Iterator DensePositionSet::begin() const {
+  return Iterator(this, 0);
+}
+
+DensePositionSet::Iterator DensePositionSet::end() const {
+  return Iterator(this, levels.size());
+}
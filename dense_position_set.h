@@ -0,0 +1,75 @@
+#pragma once
+
+#include "util.h"
+#include "position.h"
+
+// Set of positions kept as one bitmap per level, with every row starting at a word boundary.
+// Meant for large, long lived sets like known tiles, territory and zones, where a hash set spends
+// most of its time hashing and chasing nodes.
+class DensePositionSet {
+  public:
+  DensePositionSet() {}
+  explicit DensePositionSet(const PositionSet&);
+
+  // Return true if the set has changed.
+  bool insert(Position);
+  bool erase(Position);
+  bool contains(Position) const;
+  int count(Position) const;
+  int size() const;
+  bool empty() const;
+  void clear();
+  void limitToModel(const Model*);
+
+  void unionWith(const DensePositionSet&);
+  void subtract(const DensePositionSet&);
+  // Returns the set extended by all 8-neighbours of its positions.
+  DensePositionSet withMargin() const;
+
+  vector<Position> asVector() const;
+  PositionSet asPositionSet() const;
+
+  bool operator == (const DensePositionSet&) const;
+  bool operator != (const DensePositionSet&) const;
+
+  class Iterator {
+    public:
+    Iterator(const DensePositionSet*, int levelIndex);
+    const Position& operator* () const;
+    const Position* operator-> () const;
+    Iterator& operator++ ();
+    bool operator != (const Iterator&) const;
+
+    private:
+    void findNext();
+    const DensePositionSet* set;
+    int levelIndex;
+    int wordIndex = 0;
+    std::uint64_t remaining = 0;
+    Position current;
+  };
+
+  Iterator begin() const;
+  Iterator end() const;
+
+  template <class Archive>
+  void serialize(Archive&, const unsigned int);
+
+  private:
+  struct LevelBits {
+    Level* SERIAL(level) = nullptr;
+    Vec2 SERIAL(origin);
+    int SERIAL(width) = 0;
+    int SERIAL(height) = 0;
+    int SERIAL(wordsPerRow) = 0;
+    int SERIAL(count) = 0;
+    vector<std::uint64_t> SERIAL(words);
+    optional<pair<int, std::uint64_t>> getBit(Vec2) const;
+    Vec2 getCoord(int wordIndex, int bit) const;
+    SERIALIZE_ALL(level, origin, width, height, wordsPerRow, count, words)
+  };
+  const LevelBits* getBits(const Level*) const;
+  LevelBits& getOrInitBits(Level*);
+  vector<LevelBits> SERIAL(levels);
+  int SERIAL(totalCount) = 0;
+};
@@ -2738,7 +2738,7 @@ static TString getName(const Effects::Name& e, const ContentFactory*) {
 }
 
 static EffectAIIntent shouldAIApply(const Effects::Name& e, const Creature* caster, Position pos) {
-  PROFILE_BLOCK(e.text.c_str());
+  PROFILE_BLOCK(e.text.data());
   return e.effect->shouldAIApply(caster, pos);
 }
 
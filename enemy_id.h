@@ -6,3 +6,5 @@ class EnemyId : public ContentId<EnemyId> {
   public:
   using ContentId::ContentId;
 };
+
+CEREAL_CLASS_VERSION(EnemyId, 1)
@@ -1,10 +1,21 @@
 #include "stdafx.h"
 #include "event_generator.h"
 #include "event_listener.h"
+#include "game_event.h"
 
-void EventGenerator::addEvent(const GameEvent& e) {
+static vector<long long> dispatchCounts(EventInfo::numGameEventTypes, 0);
+
+void EventGenerator::addEvent(const GameEvent& e, bool local) {
+  auto mask = EventMask(1) << e.index;
   for (auto& l : listeners)
-    l.second->onEvent(e);
+    if ((l.second->subscription.events & mask) && (local || l.second->subscription.global)) {
+      ++dispatchCounts[e.index];
+      l.second->onEvent(e);
+    }
+}
+
+const vector<long long>& EventGenerator::getDispatchCounts() {
+  return dispatchCounts;
 }
 
 void EventGenerator::removeListener(EventGenerator::SubscriberId id) {
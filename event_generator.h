@@ -4,6 +4,15 @@
 
 class GameEvent;
 
+// Set of GameEvent types, see EventInfo::getEventMask().
+using EventMask = std::uint32_t;
+
+struct EventSubscription {
+  EventMask events = ~EventMask(0);
+  // Also receive events that happened in other models.
+  bool global = false;
+};
+
 class ListenerBase {
   public:
   virtual void onEvent(const GameEvent&) = 0;
@@ -12,12 +21,16 @@ class ListenerBase {
   template <class Archive>
   void serialize(Archive& ar, const unsigned int version) {
   }
+
+  EventSubscription subscription;
 };
 
 template<typename T>
 class ListenerTemplate : public ListenerBase {
   public:
-  ListenerTemplate(WeakPointer<T> p) : ptr(p) {}
+  ListenerTemplate(WeakPointer<T> p) : ptr(p) {
+    subscription = T::getEventSubscription();
+  }
   SERIALIZATION_CONSTRUCTOR(ListenerTemplate)
 
   virtual void onEvent(const GameEvent& e) override {
@@ -28,6 +41,7 @@ class ListenerTemplate : public ListenerBase {
   void serialize(Archive& ar, const unsigned int version) {
     ar & SUBCLASS(ListenerBase);
     ar(ptr);
+    subscription = T::getEventSubscription();
   }
 
   private:
@@ -38,7 +52,8 @@ class EventGenerator : public OwnedObject<EventGenerator> {
   public:
   using SubscriberId = long long;
 
-  void addEvent(const GameEvent&);
+  // Local events happened in the model that owns this generator, or aren't tied to any model.
+  void addEvent(const GameEvent&, bool local);
 
   template <typename T>
   SubscriberId addListener(WeakPointer<T> t) {
@@ -49,12 +64,12 @@ class EventGenerator : public OwnedObject<EventGenerator> {
 
   void removeListener(SubscriberId id);
 
+  // Number of onEvent calls made by all generators, indexed by GameEvent type.
+  static const vector<long long>& getDispatchCounts();
+
   template <class Archive>
   void serialize(Archive& ar, const unsigned int version);
 
   private:
   map<SubscriberId, unique_ptr<ListenerBase>> SERIAL(listeners);
 };
-
-
-
@@ -0,0 +1,521 @@
+#pragma once
+
+#include "stdafx.h"
+#include "my_containers.h"
+
+// Open addressing hash table with linear probing. Elements are stored in one flat array next to an array
+// of control bytes, which hold a few bits of each element's hash, so a lookup usually touches two cache lines
+// and compares only keys that are likely to match. Erased elements leave a tombstone until the next rehash.
+// Unlike the std containers, inserting may move the elements, so pointers, references and iterators to them
+// don't survive inserts. Erasing doesn't move anything.
+template <typename Value, typename Key, typename GetKey, typename Hash>
+class FlatHashTable {
+  public:
+  using key_type = Key;
+  using value_type = Value;
+  using size_type = std::size_t;
+  using hasher = Hash;
+
+  template <bool Const>
+  class Iterator {
+    public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Value;
+    using difference_type = std::ptrdiff_t;
+    using reference = typename std::conditional<Const, const Value&, Value&>::type;
+    using pointer = typename std::conditional<Const, const Value*, Value*>::type;
+    using TablePtr = typename std::conditional<Const, const FlatHashTable*, FlatHashTable*>::type;
+
+    Iterator() {}
+    Iterator(TablePtr table, size_type index) : table(table), index(index) {}
+    template <bool C = Const, typename = typename std::enable_if<C>::type>
+    Iterator(const Iterator<false>& o) : table(o.table), index(o.index) {}
+
+    reference operator* () const {
+      return table->slots[index];
+    }
+
+    pointer operator-> () const {
+      return &table->slots[index];
+    }
+
+    Iterator& operator++ () {
+      index = table->nextFull(index + 1);
+      return *this;
+    }
+
+    Iterator operator++ (int) {
+      auto ret = *this;
+      ++*this;
+      return ret;
+    }
+
+    bool operator == (const Iterator& o) const {
+      return index == o.index;
+    }
+
+    bool operator != (const Iterator& o) const {
+      return index != o.index;
+    }
+
+    private:
+    friend class FlatHashTable;
+    friend class Iterator<true>;
+    TablePtr table = nullptr;
+    size_type index = 0;
+  };
+
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  FlatHashTable() {}
+
+  FlatHashTable(const FlatHashTable& o) : numElems(o.numElems), numDeleted(o.numDeleted) {
+    allocate(o.capacity);
+    for (size_type i = 0; i < capacity; ++i)
+      if ((ctrl[i] = o.ctrl[i]) & fullBit)
+        new (&slots[i]) Value(o.slots[i]);
+  }
+
+  FlatHashTable(FlatHashTable&& o) noexcept {
+    swap(o);
+  }
+
+  FlatHashTable& operator = (const FlatHashTable& o) {
+    if (this != &o) {
+      FlatHashTable copy(o);
+      swap(copy);
+    }
+    return *this;
+  }
+
+  FlatHashTable& operator = (FlatHashTable&& o) noexcept {
+    swap(o);
+    return *this;
+  }
+
+  ~FlatHashTable() {
+    destroyAll();
+    ::operator delete(slots);
+  }
+
+  void swap(FlatHashTable& o) noexcept {
+    std::swap(ctrl, o.ctrl);
+    std::swap(slots, o.slots);
+    std::swap(capacity, o.capacity);
+    std::swap(numElems, o.numElems);
+    std::swap(numDeleted, o.numDeleted);
+  }
+
+  bool empty() const {
+    return numElems == 0;
+  }
+
+  void clear() {
+    destroyAll();
+    for (size_type i = 0; i < capacity; ++i)
+      ctrl[i] = emptyCtrl;
+    numElems = numDeleted = 0;
+  }
+
+  void reserve(size_type count) {
+    size_type newCapacity = minCapacity;
+    while (newCapacity * maxLoadNum < count * maxLoadDen)
+      newCapacity *= 2;
+    if (newCapacity > capacity)
+      rehash(newCapacity);
+  }
+
+  iterator begin() {
+    return iterator(this, nextFull(0));
+  }
+
+  iterator end() {
+    return iterator(this, capacity);
+  }
+
+  const_iterator begin() const {
+    return const_iterator(this, nextFull(0));
+  }
+
+  const_iterator end() const {
+    return const_iterator(this, capacity);
+  }
+
+  const_iterator cbegin() const {
+    return begin();
+  }
+
+  const_iterator cend() const {
+    return end();
+  }
+
+  iterator find(const Key& key) {
+    return iterator(this, findIndex(key));
+  }
+
+  const_iterator find(const Key& key) const {
+    return const_iterator(this, findIndex(key));
+  }
+
+  size_type count(const Key& key) const {
+    return findIndex(key) == capacity ? 0 : 1;
+  }
+
+  iterator erase(const_iterator it) {
+    eraseIndex(it.index);
+    return iterator(this, nextFull(it.index + 1));
+  }
+
+  iterator erase(iterator it) {
+    return erase(const_iterator(it));
+  }
+
+  iterator erase(const_iterator first, const_iterator last) {
+    while (first != last)
+      first = erase(first);
+    return iterator(this, last.index);
+  }
+
+  size_type erase(const Key& key) {
+    auto index = findIndex(key);
+    if (index == capacity)
+      return 0;
+    eraseIndex(index);
+    return 1;
+  }
+
+  template <typename V>
+  pair<iterator, bool> insert(V&& value) {
+    auto& key = GetKey()(value);
+    auto hash = getHash(key);
+    auto index = findIndex(key, hash);
+    if (index != capacity)
+      return make_pair(iterator(this, index), false);
+    index = insertIndex(hash);
+    new (&slots[index]) Value(std::forward<V>(value));
+    ++numElems;
+    return make_pair(iterator(this, index), true);
+  }
+
+  template <typename Iter>
+  void insert(Iter first, Iter last) {
+    for (; first != last; ++first)
+      insert(*first);
+  }
+
+  template <typename... Args>
+  pair<iterator, bool> emplace(Args&&... args) {
+    return insert(Value(std::forward<Args>(args)...));
+  }
+
+  template <typename... Args>
+  iterator emplace_hint(const_iterator, Args&&... args) {
+    return emplace(std::forward<Args>(args)...).first;
+  }
+
+  protected:
+  template <typename K, typename MakeValue>
+  Value& findOrInsert(K&& key, MakeValue makeValue) {
+    auto hash = getHash(key);
+    auto index = findIndex(key, hash);
+    if (index == capacity) {
+      index = insertIndex(hash);
+      makeValue(&slots[index], std::forward<K>(key));
+      ++numElems;
+    }
+    return slots[index];
+  }
+
+  size_type numElems = 0;
+
+  private:
+  static constexpr std::uint8_t emptyCtrl = 0;
+  static constexpr std::uint8_t deletedCtrl = 1;
+  static constexpr std::uint8_t fullBit = 0x80;
+  static constexpr size_type minCapacity = 8;
+  // The table is kept at most half full, tombstones included. Every probe ends at an empty slot, and probes stay
+  // short even though many keys, like positions, have hashes that collide or differ in only a few bits.
+  static constexpr size_type maxLoadNum = 1;
+  static constexpr size_type maxLoadDen = 2;
+
+  unique_ptr<std::uint8_t[]> ctrl;
+  Value* slots = nullptr;
+  size_type capacity = 0;
+  size_type numDeleted = 0;
+
+  // The hashes of some keys only differ in the low bits, so they are spread with a multiplication first.
+  static std::uint64_t getHash(const Key& key) {
+    return std::uint64_t(Hash()(key)) * 0x9E3779B97F4A7C15ull;
+  }
+
+  static std::uint8_t getCtrl(std::uint64_t hash) {
+    return fullBit | std::uint8_t(hash >> 57);
+  }
+
+  // The capacity is mixed in, so that neighbouring elements of a table of another size don't land in neighbouring
+  // slots. Otherwise inserting elements in the order of another table, like when loading a save, builds long runs
+  // of full slots.
+  size_type getStart(std::uint64_t hash) const {
+    auto x = hash ^ (std::uint64_t(capacity) * 0xD6E8FEB86659FD93ull);
+    x ^= x >> 32;
+    x *= 0xD6E8FEB86659FD93ull;
+    x ^= x >> 32;
+    return size_type(x & (capacity - 1));
+  }
+
+  size_type nextFull(size_type index) const {
+    while (index < capacity && !(ctrl[index] & fullBit))
+      ++index;
+    return index;
+  }
+
+  size_type findIndex(const Key& key) const {
+    return findIndex(key, getHash(key));
+  }
+
+  size_type findIndex(const Key& key, std::uint64_t hash) const {
+    if (numElems == 0)
+      return capacity;
+    auto tag = getCtrl(hash);
+    for (size_type index = getStart(hash);; index = (index + 1) & (capacity - 1)) {
+      auto c = ctrl[index];
+      if (c == emptyCtrl)
+        return capacity;
+      if (c == tag && GetKey()(slots[index]) == key)
+        return index;
+    }
+  }
+
+  // Finds a free slot for a key that isn't in the table, growing it if needed.
+  size_type insertIndex(std::uint64_t hash) {
+    if ((numElems + numDeleted + 1) * maxLoadDen > capacity * maxLoadNum) {
+      // Grow if the table is at least half full without the tombstones, otherwise just clear them out.
+      size_type newCapacity = (numElems + 1) * maxLoadDen > capacity * maxLoadNum / 2 ? capacity * 2 : capacity;
+      rehash(newCapacity < minCapacity ? minCapacity : newCapacity);
+    }
+    for (size_type index = getStart(hash);; index = (index + 1) & (capacity - 1))
+      if (!(ctrl[index] & fullBit)) {
+        if (ctrl[index] == deletedCtrl)
+          --numDeleted;
+        ctrl[index] = getCtrl(hash);
+        return index;
+      }
+  }
+
+  void eraseIndex(size_type index) {
+    slots[index].~Value();
+    // A probe never continues past an empty slot, so if the next one is empty this one can be emptied too.
+    if (ctrl[(index + 1) & (capacity - 1)] == emptyCtrl)
+      ctrl[index] = emptyCtrl;
+    else {
+      ctrl[index] = deletedCtrl;
+      ++numDeleted;
+    }
+    --numElems;
+  }
+
+  void allocate(size_type newCapacity) {
+    capacity = newCapacity;
+    if (capacity > 0) {
+      ctrl.reset(new std::uint8_t[capacity]);
+      slots = static_cast<Value*>(::operator new(capacity * sizeof(Value)));
+    }
+  }
+
+  void rehash(size_type newCapacity) {
+    auto oldCtrl = std::move(ctrl);
+    auto oldSlots = slots;
+    auto oldCapacity = capacity;
+    allocate(newCapacity);
+    for (size_type i = 0; i < capacity; ++i)
+      ctrl[i] = emptyCtrl;
+    numDeleted = 0;
+    for (size_type i = 0; i < oldCapacity; ++i)
+      if (oldCtrl[i] & fullBit) {
+        auto hash = getHash(GetKey()(oldSlots[i]));
+        auto index = getStart(hash);
+        while (ctrl[index] != emptyCtrl)
+          index = (index + 1) & (capacity - 1);
+        ctrl[index] = getCtrl(hash);
+        new (&slots[index]) Value(std::move(oldSlots[i]));
+        oldSlots[i].~Value();
+      }
+    ::operator delete(oldSlots);
+  }
+
+  void destroyAll() {
+    for (size_type i = 0; i < capacity; ++i)
+      if (ctrl[i] & fullBit)
+        slots[i].~Value();
+  }
+};
+
+namespace flat_hash_detail {
+  template <typename Key, typename Value>
+  struct GetMapKey {
+    const Key& operator() (const pair<const Key, Value>& p) const {
+      return p.first;
+    }
+    template <typename K, typename V>
+    const K& operator() (const pair<K, V>& p) const {
+      return p.first;
+    }
+  };
+
+  template <typename Key>
+  struct GetSetKey {
+    const Key& operator() (const Key& k) const {
+      return k;
+    }
+  };
+}
+
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class FlatHashMap : public FlatHashTable<pair<const Key, Value>, Key, flat_hash_detail::GetMapKey<Key, Value>, Hash> {
+  public:
+  using Base = FlatHashTable<pair<const Key, Value>, Key, flat_hash_detail::GetMapKey<Key, Value>, Hash>;
+  using mapped_type = Value;
+  using typename Base::value_type;
+  using Base::insert;
+
+  FlatHashMap() {}
+
+  FlatHashMap(std::initializer_list<value_type> values) {
+    insert(values.begin(), values.end());
+  }
+
+  template <typename Iter>
+  FlatHashMap(Iter first, Iter last) {
+    insert(first, last);
+  }
+
+  pair<typename Base::iterator, bool> insert(const value_type& value) {
+    return Base::insert(value);
+  }
+
+  pair<typename Base::iterator, bool> insert(value_type&& value) {
+    return Base::insert(std::move(value));
+  }
+
+  void insert(std::initializer_list<value_type> values) {
+    insert(values.begin(), values.end());
+  }
+
+  std::size_t size() const {
+    return this->numElems;
+  }
+
+  Value& operator[] (const Key& key) {
+    return this->findOrInsert(key, [](value_type* slot, const Key& key) {
+      new (slot) value_type(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple());
+    }).second;
+  }
+
+  Value& operator[] (Key&& key) {
+    return this->findOrInsert(std::move(key), [](value_type* slot, Key&& key) {
+      new (slot) value_type(std::piecewise_construct, std::forward_as_tuple(std::move(key)), std::forward_as_tuple());
+    }).second;
+  }
+
+  Value& at(const Key& key) {
+    auto it = this->find(key);
+    if (it == this->end())
+      throw std::out_of_range("FlatHashMap::at");
+    return it->second;
+  }
+
+  const Value& at(const Key& key) const {
+    auto it = this->find(key);
+    if (it == this->end())
+      throw std::out_of_range("FlatHashMap::at");
+    return it->second;
+  }
+
+  bool operator == (const FlatHashMap& o) const {
+    if (size() != o.size())
+      return false;
+    for (auto& elem : *this) {
+      auto it = o.find(elem.first);
+      if (it == o.end() || !(it->second == elem.second))
+        return false;
+    }
+    return true;
+  }
+
+  bool operator != (const FlatHashMap& o) const {
+    return !(*this == o);
+  }
+};
+
+template <typename Key, typename Hash = std::hash<Key>>
+class FlatHashSet : public FlatHashTable<Key, Key, flat_hash_detail::GetSetKey<Key>, Hash> {
+  public:
+  using Base = FlatHashTable<Key, Key, flat_hash_detail::GetSetKey<Key>, Hash>;
+  using Base::insert;
+
+  FlatHashSet() {}
+
+  FlatHashSet(std::initializer_list<Key> values) {
+    insert(values.begin(), values.end());
+  }
+
+  template <typename Iter>
+  FlatHashSet(Iter first, Iter last) {
+    insert(first, last);
+  }
+
+  pair<typename Base::iterator, bool> insert(const Key& key) {
+    return Base::insert(key);
+  }
+
+  pair<typename Base::iterator, bool> insert(Key&& key) {
+    return Base::insert(std::move(key));
+  }
+
+  void insert(std::initializer_list<Key> values) {
+    insert(values.begin(), values.end());
+  }
+
+  int size() const {
+    return (int) this->numElems;
+  }
+
+  template <typename Fun>
+  auto transform(Fun fun) const {
+    vector<decltype(fun(std::declval<Key>()))> ret;
+    ret.reserve(size());
+    for (const auto& elem : *this)
+      ret.push_back(fun(elem));
+    return ret;
+  }
+
+  template <typename Fun>
+  auto filter(Fun fun) const {
+    FlatHashSet ret;
+    for (const auto& elem : *this)
+      if (fun(elem))
+        ret.insert(elem);
+    return ret;
+  }
+
+  vector<Key> asVector() const {
+    vector<Key> ret;
+    for (auto&& elem : *this)
+      ret.push_back(elem);
+    return ret;
+  }
+
+  bool operator == (const FlatHashSet& o) const {
+    if (size() != o.size())
+      return false;
+    for (auto& elem : *this)
+      if (!o.count(elem))
+        return false;
+    return true;
+  }
+
+  bool operator != (const FlatHashSet& o) const {
+    return !(*this == o);
+  }
+};
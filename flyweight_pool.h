@@ -0,0 +1,108 @@
+#pragma once
+
+#include "util.h"
+#include "hashing.h"
+
+// Stores every distinct value once and refers to it by a small, reference counted id.
+// Ids of released values are reused. Equality and hash of T must cover exactly its serialized state, otherwise
+// values that were distinct before saving could be merged after loading.
+template <typename T>
+class FlyweightPool {
+  public:
+  int add(const T& value) {
+    auto it = ids.find(&value);
+    if (it != ids.end()) {
+      ++refCounts[it->second];
+      return it->second;
+    }
+    int id = getFreeId();
+    values[id] = make_unique<T>(value);
+    refCounts[id] = 1;
+    ids.insert(make_pair(values[id].get(), id));
+    return id;
+  }
+
+  // Returns true if this was the last reference and the value was destroyed.
+  bool release(int id) {
+    CHECK(refCounts[id] > 0);
+    if (--refCounts[id] > 0)
+      return false;
+    // An equal value that was loaded separately may be the one in the index, or it may already be gone.
+    auto it = ids.find(values[id].get());
+    if (it != ids.end() && it->second == id)
+      ids.erase(it);
+    values[id].reset();
+    freeIds.push_back(id);
+    return true;
+  }
+
+  const T& get(int id) const {
+    return *values[id];
+  }
+
+  int getRefCount(int id) const {
+    return refCounts[id];
+  }
+
+  int getNumValues() const {
+    return values.size() - freeIds.size();
+  }
+
+  template <class Archive>
+  void save(Archive& ar, const unsigned int) const {
+    ar(refCounts);
+    for (auto& value : values) {
+      ar(!!value);
+      if (value)
+        ar(*value);
+    }
+  }
+
+  template <class Archive>
+  void load(Archive& ar, const unsigned int) {
+    ar(refCounts);
+    ids.clear();
+    freeIds.clear();
+    values.clear();
+    for (int id : All(refCounts)) {
+      bool present;
+      ar(present);
+      if (present) {
+        values.push_back(make_unique<T>());
+        ar(*values[id]);
+        // Values that compare equal after loading stay separate, only the first one is shared from now on.
+        ids.insert(make_pair(values[id].get(), id));
+      } else {
+        values.push_back(nullptr);
+        freeIds.push_back(id);
+      }
+    }
+  }
+
+  private:
+  int getFreeId() {
+    if (!freeIds.empty()) {
+      int id = freeIds.back();
+      freeIds.pop_back();
+      return id;
+    }
+    values.push_back(nullptr);
+    refCounts.push_back(0);
+    return values.size() - 1;
+  }
+
+  struct Hash {
+    size_t operator() (const T* t) const {
+      return combineHash(*t);
+    }
+  };
+  struct Equal {
+    bool operator() (const T* t1, const T* t2) const {
+      return *t1 == *t2;
+    }
+  };
+  unordered_map<const T*, int, Hash, Equal> ids;
+  vector<unique_ptr<T>> values;
+  vector<int> refCounts;
+  vector<int> freeIds;
+};
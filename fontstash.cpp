@@ -746,6 +746,38 @@ void sth_dim_text(struct sth_stash* stash,
 	if (floorf(x) > *maxx) *maxx = floorf(x);
 }
 
+int sth_glyph_metrics(struct sth_stash* stash, int idx, float size, unsigned int codepoint,
+                      float* xoffset, float* width, float* xadvance)
+{
+  struct sth_glyph* glyph = nullptr;
+  struct sth_font* fnt = nullptr;
+	short isize = (short)(size*10.0f);
+	float scale = 1.0f;
+
+  if (stash == nullptr)
+    return 0;
+	fnt = stash->fonts;
+  while(fnt != nullptr && fnt->idx != idx)
+    fnt = fnt->next;
+  if (fnt == nullptr)
+    return 0;
+	if (fnt->type != BMFONT && !fnt->data)
+    return 0;
+	glyph = get_glyph(stash, fnt, codepoint, isize);
+	if (!glyph)
+    return 0;
+	if (fnt->type == BMFONT) scale = isize/(glyph->size*10.0f);
+	*xoffset = scale * glyph->xoff;
+	*width = scale * (glyph->x1 - glyph->x0);
+	*xadvance = scale * glyph->xadv;
+	return 1;
+}
+
+unsigned int sth_decode_utf8(unsigned int* state, unsigned int* codepoint, unsigned char byte)
+{
+	return decutf8(state, codepoint, byte);
+}
+
 void sth_vmetrics(struct sth_stash* stash,
 				  int idx, float size,
 				  float* ascender, float* descender, float* lineh)
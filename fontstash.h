@@ -54,6 +54,14 @@ void sth_draw_text(struct sth_stash* stash,
 void sth_dim_text(struct sth_stash* stash, int idx, float size, const char* string,
 				  float* minx, float* miny, float* maxx, float* maxy);
 
+// Returns 0 if the font has no glyph for the codepoint. Measuring the glyphs one by one with these metrics
+// gives the same result as sth_dim_text.
+int sth_glyph_metrics(struct sth_stash* stash, int idx, float size, unsigned int codepoint,
+                      float* xoffset, float* width, float* xadvance);
+
+// Feeds one byte of UTF-8 text into the decoder state, returns 0 once a full codepoint is decoded.
+unsigned int sth_decode_utf8(unsigned int* state, unsigned int* codepoint, unsigned char byte);
+
 void sth_vmetrics(struct sth_stash* stash,
 				  int idx, float size,
 				  float* ascender, float* descender, float * lineh);
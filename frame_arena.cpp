@@ -0,0 +1,90 @@
+#include "stdafx.h"
+#include "frame_arena.h"
+
+static constexpr size_t maxAlign = alignof(std::max_align_t);
+
+struct FrameArena::Chunk {
+  static constexpr size_t capacity = 1 << 16;
+  // One reference for every live allocation and one for the arena, so whoever drops the last one frees the chunk.
+  std::atomic<int> refs = {1};
+  size_t used = 0;
+  alignas(maxAlign) char data[capacity];
+};
+
+struct alignas(maxAlign) FrameArena::AllocationHeader {
+  Chunk* chunk;
+};
+
+void FrameArena::releaseChunk(Chunk* chunk) {
+  if (--chunk->refs == 0)
+    delete chunk;
+}
+
+FrameArena::FrameArena() {}
+
+FrameArena::~FrameArena() {
+  for (auto chunk : chunks)
+    releaseChunk(chunk);
+}
+
+void* FrameArena::allocate(size_t size) {
+  ++numAllocations;
+  numBytes += size;
+  size_t total = (sizeof(AllocationHeader) + size + maxAlign - 1) & ~(maxAlign - 1);
+  AllocationHeader* header;
+  // Big allocations would waste most of a chunk.
+  if (total > Chunk::capacity / 4) {
+    header = static_cast<AllocationHeader*>(::operator new(total));
+    header->chunk = nullptr;
+  } else {
+    while (current < chunks.size() && chunks[current]->used + total > Chunk::capacity)
+      ++current;
+    if (current == chunks.size())
+      chunks.push_back(new Chunk);
+    auto chunk = chunks[current];
+    header = reinterpret_cast<AllocationHeader*>(chunk->data + chunk->used);
+    header->chunk = chunk;
+    chunk->used += total;
+    ++chunk->refs;
+  }
+  return header + 1;
+}
+
+void FrameArena::deallocate(void* p) {
+  auto header = static_cast<AllocationHeader*>(p) - 1;
+  if (auto chunk = header->chunk)
+    releaseChunk(chunk);
+  else
+    ::operator delete(header);
+}
+
+void FrameArena::startFrame() {
+  for (auto chunk : chunks)
+    if (chunk->refs == 1)
+      chunk->used = 0;
+  current = 0;
+  numAllocations = 0;
+  numBytes = 0;
+}
+
+FrameArena::Stats FrameArena::getStats() const {
+  int numPinned = 0;
+  for (auto chunk : chunks)
+    if (chunk->refs > 1)
+      ++numPinned;
+  return Stats{numAllocations, numBytes, chunks.size(), numPinned};
+}
+
+static thread_local FrameArena* currentArena = nullptr;
+
+FrameArena::Scope::Scope(FrameArena* arena) : previous(currentArena) {
+  currentArena = arena;
+}
+
+FrameArena::Scope::~Scope() {
+  currentArena = previous;
+}
+
+FrameArena* FrameArena::getCurrent() {
+  return currentArena;
+}
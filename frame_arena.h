@@ -0,0 +1,84 @@
+#pragma once
+
+#include "stdafx.h"
+#include "util.h"
+
+// Bump allocator for objects that are created together and mostly die together, like the GUI elements of a
+// single rebuild. Memory is handed out from chunks, and every chunk counts its live allocations. startFrame()
+// rewinds the chunks whose allocations are all gone, so objects that outlive their frame only keep their own
+// chunk from being reused. Allocations may be freed on any thread, but only one thread may allocate.
+class FrameArena {
+  public:
+  FrameArena();
+  ~FrameArena();
+  FrameArena(const FrameArena&) = delete;
+
+  void* allocate(size_t size);
+  static void deallocate(void*);
+  void startFrame();
+
+  struct Stats {
+    int numAllocations;
+    size_t numBytes;
+    int numChunks;
+    int numPinnedChunks;
+  };
+  // Counts the allocations since the last startFrame().
+  Stats getStats() const;
+
+  // Makes the arena the one used by getCurrent() on this thread until the end of the scope. Pass nullptr to
+  // opt out objects that are meant to live long.
+  class Scope {
+    public:
+    Scope(FrameArena*);
+    ~Scope();
+    Scope(const Scope&) = delete;
+
+    private:
+    FrameArena* previous;
+  };
+  static FrameArena* getCurrent();
+
+  private:
+  struct Chunk;
+  struct AllocationHeader;
+  static void releaseChunk(Chunk*);
+  vector<Chunk*> chunks;
+  int current = 0;
+  int numAllocations = 0;
+  size_t numBytes = 0;
+};
+
+template <typename T>
+class FrameAllocator {
+  public:
+  using value_type = T;
+
+  FrameAllocator(FrameArena* a) : arena(a) {}
+
+  template <typename U>
+  FrameAllocator(const FrameAllocator<U>& o) : arena(o.arena) {}
+
+  T* allocate(size_t n) {
+    return static_cast<T*>(arena->allocate(n * sizeof(T)));
+  }
+
+  void deallocate(T* p, size_t) {
+    FrameArena::deallocate(p);
+  }
+
+  template <typename U>
+  bool operator == (const FrameAllocator<U>& o) const {
+    return arena == o.arena;
+  }
+
+  template <typename U>
+  bool operator != (const FrameAllocator<U>& o) const {
+    return arena != o.arena;
+  }
+
+  private:
+  template <typename U>
+  friend class FrameAllocator;
+  FrameArena* arena;
+};
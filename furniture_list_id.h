@@ -6,3 +6,5 @@ class FurnitureListId : public ContentId<FurnitureListId> {
   public:
   using ContentId::ContentId;
 };
+
+CEREAL_CLASS_VERSION(FurnitureListId, 1)
@@ -7,3 +7,5 @@ class FurnitureType : public ContentId<FurnitureType> {
   public:
   using ContentId::ContentId;
 };
+
+CEREAL_CLASS_VERSION(FurnitureType, 1)
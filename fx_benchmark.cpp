@@ -0,0 +1,132 @@
+#include "fx_benchmark.h"
+
+#include "fx_manager.h"
+#include "fx_particle_system.h"
+#include "fx_draw_buffers.h"
+#include "fx_defs.h"
+#include "clock.h"
+#include "renderer.h"
+
+// Counts the allocations made through operator new by the thread that runs the benchmark, so that the log
+// thread doesn't get counted. Replacing operator new affects the whole game, so it's only done in builds
+// made with COUNT_ALLOCATIONS.
+static thread_local bool countAllocations = false;
+static thread_local long long numAllocations = 0;
+
+#ifdef COUNT_ALLOCATIONS
+void* operator new(size_t size) {
+  if (countAllocations)
+    ++numAllocations;
+  if (void* ret = malloc(size == 0 ? 1 : size))
+    return ret;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+  free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+  free(p);
+}
+#endif
+
+namespace fx {
+
+namespace {
+struct Stopwatch {
+  Stopwatch() : start(Clock::getRealMicros().count()) {}
+  long long get() const {
+    return Clock::getRealMicros().count() - start;
+  }
+  long long start;
+};
+}
+
+void runBenchmark(const BenchmarkConfig& config, ostream& out) {
+  CHECK(config.instancesPerEffect > 0 && config.numFrames > 0);
+  FXManager manager;
+  const int numEffects = EnumInfo<FXName>::size;
+  const int gridWidth = int(ceil(sqrt(double(numEffects * config.instancesPerEffect))));
+  vector<pair<FXName, InitConfig>> spawns;
+  for (auto name : ENUM_ALL(FXName))
+    for (int i = 0; i < config.instancesPerEffect; ++i) {
+      int index = spawns.size();
+      auto pos = (FVec2(index % gridWidth, index / gridWidth) + FVec2(0.5f)) * Renderer::nominalSize;
+      spawns.emplace_back(name, InitConfig(pos, FVec2(3, 2) * Renderer::nominalSize));
+    }
+  vector<ParticleSystemId> ids;
+  for (auto& spawn : spawns)
+    ids.push_back(manager.addSystem(spawn.first, spawn.second));
+
+  vector<DrawParticle> quads;
+  DrawBuffers drawBuffers;
+  EnumMap<FXName, long long> particlesPerEffect;
+
+  long long simulateMicros = 0;
+  long long quadsMicros = 0;
+  long long numSimulatedParticles = 0;
+  long long numQuads = 0;
+  long long simulateAllocations = 0;
+  long long quadsAllocations = 0;
+  int numRespawned = 0;
+  const double frameTime = 1.0 / config.visibleFps;
+  Stopwatch totalTime;
+  countAllocations = true;
+  for (int frame = 0; frame < config.numFrames; ++frame) {
+    for (int i : All(ids))
+      if (manager.dead(ids[i])) {
+        ids[i] = manager.addSystem(spawns[i].first, spawns[i].second);
+        ++numRespawned;
+      }
+    auto& systems = manager.getSystems();
+    {
+      Stopwatch watch;
+      auto allocations = numAllocations;
+      manager.simulateStable(frameTime, config.visibleFps);
+      simulateAllocations += numAllocations - allocations;
+      simulateMicros += watch.get();
+    }
+    for (auto& system : systems)
+      if (!system.isDead) {
+        int numActive = system.numActiveParticles();
+        numSimulatedParticles += numActive;
+        particlesPerEffect[system.defId] += numActive;
+      }
+    {
+      Stopwatch watch;
+      auto allocations = numAllocations;
+      quads.clear();
+      drawBuffers.clear();
+      for (int id : All(systems))
+        for (int ssid : All(systems[id].subSystems))
+          manager.genQuads(quads, id, ssid);
+      drawBuffers.add(quads.data(), quads.size());
+      quadsAllocations += numAllocations - allocations;
+      quadsMicros += watch.get();
+    }
+    numQuads += quads.size();
+  }
+  countAllocations = false;
+  auto perItem = [](long long micros, long long count) {
+    return count > 0 ? double(micros) * 1000.0 / double(count) : 0.0;
+  };
+  out << "FX benchmark: " << numEffects << " effects x " << config.instancesPerEffect << " instances, "
+      << config.numFrames << " frames, " << totalTime.get() / 1000 << " msec total\n";
+  out << "Simulation: " << simulateMicros / 1000 << " msec, " << numSimulatedParticles << " particle updates, "
+      << perItem(simulateMicros, numSimulatedParticles) << " ns/particle\n";
+  out << "Quad generation: " << quadsMicros / 1000 << " msec, " << numQuads << " quads, "
+      << perItem(quadsMicros, numQuads) << " ns/quad\n";
+#ifdef COUNT_ALLOCATIONS
+  out << "Allocations: " << simulateAllocations << " in simulation, " << quadsAllocations
+      << " in quad generation\n";
+#else
+  out << "Allocations: not counted, build with COUNT_ALLOCATIONS to count them\n";
+#endif
+  out << "Respawned systems: " << numRespawned << "\n";
+  for (auto name : ENUM_ALL(FXName))
+    out << ENUM_STRING(name) << " " << double(particlesPerEffect[name]) / config.numFrames / config.instancesPerEffect
+        << " particles per instance\n";
+  out << std::flush;
+}
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "fx_base.h"
+
+namespace fx {
+
+struct BenchmarkConfig {
+  int instancesPerEffect = 10;
+  int numFrames = 600;
+  int visibleFps = 60;
+};
+
+// Spawns every FXName, simulates it and generates quads without touching OpenGL,
+// so that it can be used on machines without a GPU.
+// Prints timings (ns per particle) and, in builds made with COUNT_ALLOCATIONS, the number of heap allocations
+// made in each phase.
+void runBenchmark(const BenchmarkConfig&, ostream&);
+}
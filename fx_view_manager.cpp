@@ -212,7 +212,7 @@ void FXViewManager::drawFX(Renderer& renderer, GenericId id, Color color) {
   }
 
   if (num > 0) {
-    renderer.renderDeferredSprites();
+    renderer.flushCommands();
     float px = (entity.x) * Renderer::nominalSize * m_zoomX;
     float py = (entity.y) * Renderer::nominalSize * m_zoomY;
     fxRenderer->drawOrdered(ids, num, px, py, color);
@@ -220,12 +220,12 @@ void FXViewManager::drawFX(Renderer& renderer, GenericId id, Color color) {
 }
 
 void FXViewManager::drawUnorderedBackFX(Renderer& renderer) {
-  renderer.renderDeferredSprites();
+  renderer.flushCommands();
   fxRenderer->drawUnordered(fx::Layer::back);
 }
 
 void FXViewManager::drawUnorderedFrontFX(Renderer& renderer) {
-  renderer.renderDeferredSprites();
+  renderer.flushCommands();
   fxRenderer->drawUnordered(fx::Layer::front);
 }
 
@@ -476,7 +476,7 @@ void Game::tick(GlobalTime time) {
     turnEvents.erase(turn);
   }
   updateSunlightMovement();
-  INFO << "Global time " << time;
+  INFO_VERBOSE << "Global time " << time;
   for (Collective* col : collectives) {
     if (isVillainActive(col))
       col->update(col->getModel() == getCurrentModel());
@@ -966,13 +966,44 @@ void Game::clearPlayerControl() {
   playerControl = nullptr;
 }
 
+// Returns null for events that concern all models.
+static Model* getEventModel(const GameEvent& event) {
+  using namespace EventInfo;
+  auto creatureModel = [](const Creature* c) { return c ? c->getPosition().getModel() : nullptr; };
+  return event.visit<Model*>(
+      [&](const CreatureMoved& info) { return creatureModel(info.creature); },
+      [&](const CreatureKilled& info) { return creatureModel(info.victim); },
+      [&](const ItemsPickedUp& info) { return creatureModel(info.creature); },
+      [&](const ItemsDropped& info) { return creatureModel(info.creature); },
+      [&](const ItemsAppeared& info) { return info.position.getModel(); },
+      [&](const Projectile& info) { return info.begin.getModel(); },
+      [&](const ConqueredEnemy& info) { return info.collective->getModel(); },
+      [&](const Alarm& info) { return info.pos.getModel(); },
+      [&](const CreatureTortured& info) { return creatureModel(info.victim); },
+      [&](const CreatureStunned& info) { return creatureModel(info.victim); },
+      [&](const CreatureAttacked& info) { return creatureModel(info.victim); },
+      [&](const MovementChanged& info) { return info.pos.getModel(); },
+      [&](const VisibilityChanged& info) { return info.level->getModel(); },
+      [&](const LeaderWounded& info) { return creatureModel(info.c); },
+      [&](const TrapDisarmed& info) { return info.pos.getModel(); },
+      [&](const FurnitureRemoved& info) { return info.position.getModel(); },
+      [&](const ItemsOwned& info) { return creatureModel(info.creature); },
+      [&](const CreatureEvent& info) { return creatureModel(info.creature); },
+      [&](const FX& info) { return info.position.getModel(); },
+      [&](const ItemStolen& info) { return info.shopPosition.getModel(); },
+      [&](const auto&) -> Model* { return nullptr; }
+  );
+}
+
 void Game::addEvent(const GameEvent& event) {
   if (event.contains<EventInfo::CreatureMoved>() && !!playerControl)
     playerControl->onEvent(event); // shortcut to optimize because only PlayerControl cares about this event
-  else
+  else {
+    auto eventModel = getEventModel(event);
     for (Vec2 v : models.getBounds())
       if (models[v])
-        models[v]->addEvent(event);
+        models[v]->addEvent(event, !eventModel || eventModel == models[v].get());
+  }
   using namespace EventInfo;
   event.visit<void>(
       [&](const ConqueredEnemy& info) {
@@ -8,6 +8,7 @@
 #include "tech_id.h"
 #include "attr_type.h"
 #include "t_string.h"
+#include "event_generator.h"
 
 class Model;
 class Technology;
@@ -118,8 +119,10 @@ namespace EventInfo {
     Position shopPosition;
   };
 
+  // Sent once per changed square, with all tiles that could see it.
   struct VisibilityChanged {
-    Position pos;
+    Level* level = nullptr;
+    vector<SVec2> positions;
   };
 
   struct MovementChanged {
@@ -160,9 +163,31 @@ namespace EventInfo {
 
 #include "gen_variant.h"
 
+  template <typename T>
+  struct EventIndex;
+
+#define X(Type, Index) \
+  template <> \
+  struct EventIndex<Type> { static constexpr int value = Index; };
+  VARIANT_TYPES_LIST
+#undef X
+
+#define X(Type, Index) + 1
+  constexpr int numGameEventTypes = 0 VARIANT_TYPES_LIST;
+#undef X
+
 #undef VARIANT_TYPES_LIST
 #undef VARIANT_NAME
 
+  static_assert(numGameEventTypes <= 8 * sizeof(EventMask), "Too many event types for EventMask");
+
+  template <typename... Types>
+  EventMask getEventMask() {
+    EventMask ret = 0;
+    for (int index : {EventIndex<Types>::value...})
+      ret |= EventMask(1) << index;
+    return ret;
+  }
 }
 
 class GameEvent : public EventInfo::GameEvent {
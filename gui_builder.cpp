@@ -71,6 +71,14 @@ void GuiBuilder::clearCache() {
   cache = CallCache<SGuiElem>(1000);
 }
 
+template <typename... Args, typename Generator>
+SGuiElem GuiBuilder::getCached(Generator gen, int id, Args&&... args) {
+  return cache->get([&gen] (auto&&... genArgs) -> SGuiElem {
+        FrameArena::Scope scope(nullptr);
+        return gen(std::forward<decltype(genArgs)>(genArgs)...);
+      }, id, std::forward<Args>(args)...);
+}
+
 void GuiBuilder::reset() {
   gameSpeed = GameSpeed::NORMAL;
   tutorialClicks.clear();
@@ -241,7 +249,7 @@ SGuiElem GuiBuilder::getButtonLine(CollectiveInfo::Button button, int num, const
         tutorialElem,
         line.buildHorizontalList())));
 //  };
-//  return cache->get(getValue, THIS_LINE, button, num, tutorial);
+//  return getCached(getValue, THIS_LINE, button, num, tutorial);
 }
 
 static optional<int> getFirstActive(const vector<CollectiveInfo::Button>& buttons, int begin) {
@@ -648,7 +656,7 @@ SGuiElem GuiBuilder::drawRightBandInfo(GameInfo& info) {
             buttons[3]);
     vector<pair<CollectiveTab, SGuiElem>> elems = makeVec(
         make_pair(CollectiveTab::MINIONS, drawMinions(collectiveInfo, minionsIndex, info.tutorial)),
-        make_pair(CollectiveTab::BUILDINGS, cache->get(bindMethod(
+        make_pair(CollectiveTab::BUILDINGS, getCached(bindMethod(
             &GuiBuilder::drawBuildings, this), THIS_LINE, collectiveInfo.buildings, info.tutorial)),
         make_pair(CollectiveTab::KEY_MAPPING, drawKeeperHelp(info)),
         make_pair(CollectiveTab::TECHNOLOGY, drawLibraryContent(collectiveInfo, info.tutorial))
@@ -1174,13 +1182,13 @@ SGuiElem GuiBuilder::drawImmigrationOverlay(const vector<ImmigrantDataInfo>& imm
     if (elem.requirements.empty())
       button = WL(stack, makeVec(
           WL(sprite, GuiFactory::TexId::IMMIGRANT_BG, GuiFactory::Alignment::CENTER),
-          cache->get(getAcceptButton, THIS_LINE, elem.id, elem.keybinding),
-          cache->get(getRejectButton, THIS_LINE, elem.id)
+          getCached(getAcceptButton, THIS_LINE, elem.id, elem.keybinding),
+          getCached(getRejectButton, THIS_LINE, elem.id)
       ));
     else
       button = WL(stack, makeVec(
           WL(sprite, GuiFactory::TexId::IMMIGRANT2_BG, GuiFactory::Alignment::CENTER),
-          cache->get(getRejectButton, THIS_LINE, elem.id)
+          getCached(getRejectButton, THIS_LINE, elem.id)
       ));
     if (!elem.specialTraits.empty())
       button = WL(stack,
@@ -1292,7 +1300,7 @@ vector<SGuiElem> GuiBuilder::drawPlayerAttributes(const vector<AttributeInfo>& a
               WL(margins, WL(label, attrText), 0, 2, 0, 0)), 30));
     };
     if (elem.value != 0 || elem.bonus != 0)
-      ret.push_back(cache->get(getValue, THIS_LINE, elem));
+      ret.push_back(getCached(getValue, THIS_LINE, elem));
   }
   return ret;
 }
@@ -1421,7 +1429,7 @@ SGuiElem GuiBuilder::getItemLine(const ItemInfo& item, function<void(Rectangle)>
 }
 
 SGuiElem GuiBuilder::getTooltip(const vector<TString>& text, int id, milliseconds delay, bool forceEnableTooltip) {
-  return cache->get(
+  return getCached(
       [this, delay, forceEnableTooltip](const vector<TString>& text) {
         return forceEnableTooltip
             ? WL(tooltip, text, delay)
@@ -2274,7 +2282,7 @@ SGuiElem GuiBuilder::drawTeams(const CollectiveInfo& info, const optional<Tutori
             }),
             WL(mouseOverAction, [team, this] { mapGui->highlightTeam(team.members); },
                 [team, this] { mapGui->unhighlightTeam(team.members); }),
-            cache->get(selectButton, THIS_LINE, team.id),
+            getCached(selectButton, THIS_LINE, team.id),
             WL(dragListener, [this, team](DragContent content) {
                 content.visit<void>(
                     [&](UniqueEntity<Creature>::Id id) {
@@ -2309,7 +2317,7 @@ SGuiElem GuiBuilder::drawMinions(const CollectiveInfo& info, optional<int> minio
         elem.count > 1 ? makePlural(elem.name) : elem.name), Color::WHITE);
     line.addElem(WL(renderInBounds, std::move(tmp)), 200);
     auto callback = getButtonCallback({UserInputId::CREATURE_GROUP_BUTTON, elem.name});
-    auto selectButton = cache->get([this](const TString& group) {
+    auto selectButton = getCached([this](const TString& group) {
       return WL(releaseLeftButton, getButtonCallback({UserInputId::CREATURE_GROUP_BUTTON, group}));
     }, THIS_LINE, elem.name);
     list.addElem(WL(stack, makeVec(
@@ -2751,7 +2759,7 @@ SGuiElem GuiBuilder::drawWorkshopsOverlay(const CollectiveInfo::ChosenWorkshopIn
       upgradesTip = TString(TSentence("UPGRADABLE_WITH_UP_TO", TString(maxUpgrades.second),
           maxUpgrades.second > 1 ? makePlural(maxUpgrades.first) : maxUpgrades.first));
     if (creatureInfo) {
-      return cache->get(
+      return getCached(
           [this](const ImmigrantCreatureInfo& creature, const optional<TString>& warning, optional<TString> upgradesTip) {
             auto lines = WL(getListBuilder, legendLineHeight)
                 .addElemAuto(drawImmigrantCreature(creature));
@@ -3292,7 +3300,7 @@ SGuiElem GuiBuilder::drawBestiaryButtons(const vector<PlayerInfo>& minions, int
           (i == index ? WL(uiHighlightLine) : WL(empty)),
           line.buildHorizontalList()));
   }
-  auto searchBox = cache->get([this] {
+  auto searchBox = getCached([this] {
     return WL(textField, 15, [this]{ return bestiarySearchString; }, [this](string s) { bestiarySearchString = s;}, []{ return false; });
   }, 0);
   return WL(getListBuilder, legendLineHeight)
@@ -3651,21 +3659,21 @@ SGuiElem GuiBuilder::drawScreenshotOverlay() {
 
 void GuiBuilder::drawOverlays(vector<OverlayInfo>& ret, const GameInfo& info) {
   if (info.takingScreenshot) {
-    ret.push_back({cache->get(bindMethod(&GuiBuilder::drawScreenshotOverlay, this), THIS_LINE),
+    ret.push_back({getCached(bindMethod(&GuiBuilder::drawScreenshotOverlay, this), THIS_LINE),
         OverlayInfo::CENTER});
     return;
   }
   if (info.tutorial)
-    ret.push_back({cache->get(bindMethod(&GuiBuilder::drawTutorialOverlay, this), THIS_LINE,
+    ret.push_back({getCached(bindMethod(&GuiBuilder::drawTutorialOverlay, this), THIS_LINE,
          *info.tutorial), OverlayInfo::TUTORIAL});
   switch (info.infoType) {
     case GameInfo::InfoType::BAND: {
       auto& collectiveInfo = *info.playerInfo.getReferenceMaybe<CollectiveInfo>();
       if (!info.tutorial)
-        ret.push_back({cache->get(bindMethod(&GuiBuilder::drawVillainsOverlay, this), THIS_LINE,
+        ret.push_back({getCached(bindMethod(&GuiBuilder::drawVillainsOverlay, this), THIS_LINE,
                 info.villageInfo, collectiveInfo.nextWave, collectiveInfo.rebellionChance, villainsIndex),
             OverlayInfo::VILLAINS});
-      ret.push_back({cache->get(bindMethod(&GuiBuilder::drawImmigrationOverlay, this), THIS_LINE,
+      ret.push_back({getCached(bindMethod(&GuiBuilder::drawImmigrationOverlay, this), THIS_LINE,
           collectiveInfo.immigration, info.tutorial, !collectiveInfo.allImmigration.empty()),
           OverlayInfo::IMMIGRATION});
       if (!collectiveInfo.chosenCreature)
@@ -3677,25 +3685,25 @@ void GuiBuilder::drawOverlays(vector<OverlayInfo>& ret, const GameInfo& info) {
             break;
           }
       if (collectiveInfo.chosenCreature)
-        ret.push_back({cache->get(bindMethod(&GuiBuilder::drawMinionsOverlay, this), THIS_LINE,
+        ret.push_back({getCached(bindMethod(&GuiBuilder::drawMinionsOverlay, this), THIS_LINE,
             *collectiveInfo.chosenCreature, info.tutorial), OverlayInfo::TOP_LEFT});
       else if (collectiveInfo.chosenWorkshop) {
         updateWorkshopIndex(*collectiveInfo.chosenWorkshop);
-        ret.push_back({cache->get(bindMethod(&GuiBuilder::drawWorkshopsOverlay, this), THIS_LINE,
+        ret.push_back({getCached(bindMethod(&GuiBuilder::drawWorkshopsOverlay, this), THIS_LINE,
             *collectiveInfo.chosenWorkshop, info.tutorial, workshopIndex), OverlayInfo::TOP_LEFT});
       } else if (bottomWindow == TASKS)
-        ret.push_back({cache->get(bindMethod(&GuiBuilder::drawTasksOverlay, this), THIS_LINE,
+        ret.push_back({getCached(bindMethod(&GuiBuilder::drawTasksOverlay, this), THIS_LINE,
             collectiveInfo), OverlayInfo::TOP_LEFT});
-      ret.push_back({cache->get(bindMethod(&GuiBuilder::drawBuildingsOverlay, this), THIS_LINE,
+      ret.push_back({getCached(bindMethod(&GuiBuilder::drawBuildingsOverlay, this), THIS_LINE,
           collectiveInfo.buildings, info.tutorial), OverlayInfo::TOP_LEFT});
       if (bottomWindow == IMMIGRATION_HELP)
-        ret.push_back({cache->get(bindMethod(&GuiBuilder::drawImmigrationHelp, this), THIS_LINE,
+        ret.push_back({getCached(bindMethod(&GuiBuilder::drawImmigrationHelp, this), THIS_LINE,
             collectiveInfo), OverlayInfo::BOTTOM_LEFT});
       break;
     }
     case GameInfo::InfoType::PLAYER: {
       auto& playerInfo = *info.playerInfo.getReferenceMaybe<PlayerInfo>();
-      ret.push_back({cache->get(bindMethod(&GuiBuilder::drawPlayerOverlay, this), THIS_LINE,
+      ret.push_back({getCached(bindMethod(&GuiBuilder::drawPlayerOverlay, this), THIS_LINE,
           playerInfo, playerOverlayFocused), OverlayInfo::TOP_LEFT});
       break;
     }
@@ -3723,17 +3731,17 @@ void GuiBuilder::drawOverlays(vector<OverlayInfo>& ret, const GameInfo& info) {
   if (bottomWindow == BESTIARY) {
     if (bestiaryIndex >= info.encyclopedia->bestiary.size())
       bestiaryIndex = 0;
-    ret.push_back({cache->get(bindMethod(&GuiBuilder::drawBestiaryOverlay, this), THIS_LINE,
+    ret.push_back({getCached(bindMethod(&GuiBuilder::drawBestiaryOverlay, this), THIS_LINE,
          info.encyclopedia->bestiary, bestiaryIndex, bestiarySearchString), OverlayInfo::TOP_LEFT});
   }
   if (bottomWindow == SPELL_SCHOOLS) {
     if (spellSchoolIndex >= info.encyclopedia->spellSchools.size())
       spellSchoolIndex = 0;
-    ret.push_back({cache->get(bindMethod(&GuiBuilder::drawSpellSchoolsOverlay, this), THIS_LINE,
+    ret.push_back({getCached(bindMethod(&GuiBuilder::drawSpellSchoolsOverlay, this), THIS_LINE,
          info.encyclopedia->spellSchools, spellSchoolIndex), OverlayInfo::TOP_LEFT});
   }
   if (bottomWindow == ITEMS_HELP)
-    ret.push_back({cache->get(bindMethod(&GuiBuilder::drawItemsHelpOverlay, this), THIS_LINE,
+    ret.push_back({getCached(bindMethod(&GuiBuilder::drawItemsHelpOverlay, this), THIS_LINE,
          info.encyclopedia->items), OverlayInfo::TOP_LEFT});
   ret.push_back({drawMapHintOverlay(), OverlayInfo::MAP_HINT});
 }
@@ -3902,7 +3910,7 @@ SGuiElem GuiBuilder::drawMinionButtons(const vector<PlayerInfo>& minions1, Uniqu
     auto lineTmp = line.buildHorizontalList();
     allLines.push_back(lineTmp);
     list.addElem(WL(stack, makeVec(
-          cache->get(selectButton, THIS_LINE, minionId),
+          getCached(selectButton, THIS_LINE, minionId),
           WL(leftMargin, teamId ? -10 : 0, WL(stack,
                WL(uiHighlightLineConditional, [=] { return !teamId && mapGui->isCreatureHighlighted(minionId);}, Color::YELLOW),
                WL(uiHighlightLineConditional, [=] { return current == minionId;}),
@@ -279,6 +279,9 @@ class GuiBuilder {
   shared_ptr<MapGui> mapGui;
   int getImmigrantAnimationOffset(milliseconds initTime);
   HeapAllocated<CallCache<SGuiElem>> cache;
+  // Cached elements outlive the rebuild that made them, so they stay out of its frame arena.
+  template <typename... Args, typename Generator>
+  SGuiElem getCached(Generator, int id, Args&&...);
   SGuiElem drawTutorialOverlay(const TutorialInfo&);
   HashSet<pair<int, TutorialHighlight>> tutorialClicks;
   bool wasTutorialClicked(size_t hash, TutorialHighlight);
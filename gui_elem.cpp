@@ -35,6 +35,7 @@
 #include "t_string.h"
 #include "translations.h"
 #include "game_config.h"
+#include "call_cache.h"
 
 using SDL::SDL_Keysym;
 using SDL::SDL_Keycode;
@@ -207,15 +208,15 @@ DragContainer& GuiFactory::getDragContainer() {
 }
 
 SGuiElem GuiFactory::button(function<void()> fun, SDL_Keysym hotkey, bool capture) {
-  return SGuiElem(new ButtonKey([=](Rectangle) { fun(); }, hotkey, capture));
+  return makeGuiElem<ButtonKey>([=](Rectangle) { fun(); }, hotkey, capture);
 }
 
 SGuiElem GuiFactory::buttonRect(function<void(Rectangle)> fun) {
-  return SGuiElem(new ButtonElem([=](Rectangle b, Vec2) {fun(b);}, false));
+  return makeGuiElem<ButtonElem>([=](Rectangle b, Vec2) {fun(b);}, false);
 }
 
 SGuiElem GuiFactory::button(function<void()> fun, bool capture) {
-  return SGuiElem(new ButtonElem([=](Rectangle, Vec2) { fun(); }, capture));
+  return makeGuiElem<ButtonElem>([=](Rectangle, Vec2) { fun(); }, capture);
 }
 
 namespace  {
@@ -328,18 +329,18 @@ class TextFieldElem : public GuiElem {
 SGuiElem GuiFactory::textField(int maxLength, function<string()> text, function<void(string)> callback,
     function<bool()> controllerFocus) {
   return topMargin(-4, bottomMargin(4,
-      make_shared<TextFieldElem>(std::move(text), std::move(callback), std::move(controllerFocus),
+      makeGuiElem<TextFieldElem>(std::move(text), std::move(callback), std::move(controllerFocus),
           maxLength, false, getSteamInput(), getKeybindingMap())));
 }
 
 SGuiElem GuiFactory::textFieldFocused(int maxLength, function<string()> text, function<void(string)> callback) {
   return topMargin(-4, bottomMargin(4,
-      make_shared<TextFieldElem>(std::move(text), std::move(callback), []{return false;},
+      makeGuiElem<TextFieldElem>(std::move(text), std::move(callback), []{return false;},
           maxLength, true, getSteamInput(), getKeybindingMap())));
 }
 
 SGuiElem GuiFactory::buttonPos(function<void (Rectangle, Vec2)> fun) {
-  return make_shared<ButtonElem>(fun, false);
+  return makeGuiElem<ButtonElem>(fun, false);
 }
 
 namespace {
@@ -361,18 +362,18 @@ class ButtonRightClick : public GuiElem {
 }
 
 SGuiElem GuiFactory::buttonRightClick(function<void ()> fun) {
-  return SGuiElem(new ButtonRightClick([fun](Rectangle) { fun(); }));
+  return makeGuiElem<ButtonRightClick>([fun](Rectangle) { fun(); });
 }
 
 SGuiElem GuiFactory::releaseLeftButton(function<void()> fun, optional<Keybinding> key) {
-  auto ret = SGuiElem(new ReleaseButton(fun, 0));
+  SGuiElem ret = makeGuiElem<ReleaseButton>(fun, 0);
   if (key)
     ret = stack(std::move(ret), keyHandler(fun, *key, false));
   return ret;
 }
 
 SGuiElem GuiFactory::releaseRightButton(function<void()> fun) {
-  return SGuiElem(new ReleaseButton(fun, 1));
+  return makeGuiElem<ReleaseButton>(fun, 1);
 }
 
 class ReverseButton : public GuiElem {
@@ -395,7 +396,7 @@ class ReverseButton : public GuiElem {
 SGuiElem GuiFactory::reverseButton(function<void()> fun, Keybinding hotkey, bool capture) {
   return stack(
       keyHandler(fun, hotkey, true),
-      SGuiElem(new ReverseButton(fun, capture)));
+      makeGuiElem<ReverseButton>(fun, capture));
 }
 
 
@@ -416,7 +417,7 @@ class MouseWheel : public GuiElem {
 };
 
 SGuiElem GuiFactory::mouseWheel(function<void(bool)> fun) {
-  return SGuiElem(new MouseWheel(fun));
+  return makeGuiElem<MouseWheel>(fun);
 }
 
 class DrawCustom : public GuiElem {
@@ -446,30 +447,30 @@ class DrawCustom : public GuiElem {
 };
 
 SGuiElem GuiFactory::drawCustom(CustomDrawFun fun) {
-  return make_shared<DrawCustom>(fun);
+  return makeGuiElem<DrawCustom>(fun);
 }
 
 SGuiElem GuiFactory::rectangle(Color color, optional<Color> borderColor) {
-  return SGuiElem(new DrawCustom(
+  return makeGuiElem<DrawCustom>(
         [=] (Renderer& r, Rectangle bounds) {
           r.drawFilledRectangle(bounds, color, borderColor);
-        }));
+        });
 }
 
 SGuiElem GuiFactory::repeatedPattern(Texture& tex) {
-  return SGuiElem(new DrawCustom(
+  return makeGuiElem<DrawCustom>(
         [&tex] (Renderer& r, Rectangle bounds) {
           r.drawSprite(bounds.topLeft(), Vec2(0, 0), Vec2(bounds.width(), bounds.height()), tex);
-        }));
+        });
 }
 
 SGuiElem GuiFactory::sprite(Texture& tex, double height) {
-  return SGuiElem(new DrawCustom(
+  return makeGuiElem<DrawCustom>(
         [&tex, height] (Renderer& r, Rectangle bounds) {
           Vec2 size = tex.getSize();
           r.drawSprite(bounds.topLeft(), Vec2(0, 0), size, tex,
               Vec2(height * size.x / size.y, height));
-        }));
+        });
 }
 
 class DrawScripted : public GuiElem {
@@ -573,14 +574,14 @@ SGuiElem GuiFactory::scripted(function<void()> endCallback, ScriptedUIId id, con
     ScriptedUIState& state) {
   if (!state.highlightedElem && !getSteamInput()->controllers.empty())
     state.highlightedElem = 0;
-  return SGuiElem(new DrawScripted(ScriptedContext{&renderer, this, endCallback, state, 0, 0}, id, data));
+  return makeGuiElem<DrawScripted>(ScriptedContext{&renderer, this, endCallback, state, 0, 0}, id, data);
 }
 
 SGuiElem GuiFactory::sprite(Texture& tex, Alignment align, bool vFlip, bool hFlip, Vec2 offset,
     optional<Color> col) {
   if (!tex.getTexId())
     return empty();
-  return SGuiElem(new DrawCustom(
+  return makeGuiElem<DrawCustom>(
         [&tex, align, offset, col, vFlip, hFlip] (Renderer& r, Rectangle bounds) {
           Vec2 size = tex.getSize();
           optional<Vec2> stretchSize;
@@ -649,19 +650,19 @@ SGuiElem GuiFactory::sprite(Texture& tex, Alignment align, bool vFlip, bool hFli
           }
           r.drawSprite(pos, origin, size, tex, stretchSize, !!col ? *col : Color::WHITE,
               Renderer::SpriteOrientation(vFlip, hFlip));
-        }));
+        });
 }
 
 SGuiElem GuiFactory::label(const TString& ts, Color c, char hotkey) {
   auto s = translate(ts);
-  return SGuiElem(new DrawCustom(
+  return makeGuiElem<DrawCustom>(
         [=] (Renderer& r, Rectangle bounds) {
           //r.setScissor(bounds);
           r.drawTextWithHotkey(Color::BLACK.transparency(100),
             bounds.topLeft() + Vec2(1, 2), s, 0);
           r.drawTextWithHotkey(c, bounds.topLeft(), s, hotkey);
           //r.setScissor(none);
-        }, renderer.getTextSize(s)));
+        }, renderer.getTextSize(s));
 }
 
 static vector<string> breakWord(Renderer& renderer, string word, int maxWidth, int size) {
@@ -670,9 +671,12 @@ static vector<string> breakWord(Renderer& renderer, string word, int maxWidth, i
   vector<string> ret;
   while (!word.empty()) {
     int maxSubstr = 0;
-    for (int i : Range(word.size()))
-      if (renderer.getTextLength(word.substr(0, i + 1), size) <= maxWidth)
+    Renderer::TextWidth width;
+    for (int i : Range(word.size())) {
+      renderer.addText(width, word.substr(i, 1), size);
+      if (width.get() <= maxWidth)
         maxSubstr = i + 1;
+    }
     CHECK(maxSubstr > 0) << "Couldn't fit single character in line " << word << " line width " << maxWidth;
     ret.push_back(word.substr(0, maxSubstr));
     word = word.substr(maxSubstr);
@@ -680,32 +684,55 @@ static vector<string> breakWord(Renderer& renderer, string word, int maxWidth, i
   return ret;
 }
 
-static vector<string> breakText(Renderer& renderer, const string& text, int maxWidth, int size = Renderer::textSize(),
-    char delim = ' ') {
+static vector<string> breakTextImpl(Renderer& renderer, const string& text, int maxWidth, int size, char delim) {
   if (renderer.getTextLength(text, size) <= maxWidth)
-    return {std::move(text)};
+    return {text};
   vector<string> rows;
   for (string line : split(text, {'\n'})) {
     rows.push_back("");
+    Renderer::TextWidth rowWidth;
     for (string word : splitIncludeDelim(line, {delim})) {
       for (string subword : breakWord(renderer, word, maxWidth, size)) {
-        auto addWord = [&](string& row, string word) {
-          if (row.empty() && word == string(1, delim))
-            return;
-          if (row.empty())
-            while (!word.empty() && word[0] == ' ')
-              word = word.substr(1);
-          row += std::move(word);
-        };
-        if (!rows.back().empty() && renderer.getTextLength(rows.back() + subword, size) > maxWidth)
+        if (!rows.back().empty()) {
+          auto newWidth = rowWidth;
+          renderer.addText(newWidth, subword, size);
+          if (newWidth.get() <= maxWidth) {
+            rows.back() += subword;
+            rowWidth = newWidth;
+            continue;
+          }
           rows.emplace_back();
-        addWord(rows.back(), subword);
+          rowWidth = Renderer::TextWidth();
+        }
+        if (subword == string(1, delim))
+          continue;
+        while (!subword.empty() && subword[0] == ' ')
+          subword = subword.substr(1);
+        renderer.addText(rowWidth, subword, size);
+        rows.back() += std::move(subword);
       }
     }
   }
   return rows;
 }
 
+// Multi line labels break their text on every frame, and the same texts come back with every GUI rebuild.
+// The cache only keeps hashes of the arguments, so the text is kept with the lines to rule out collisions.
+static vector<string> breakText(Renderer& renderer, const string& text, int maxWidth, int size = Renderer::textSize(),
+    char delim = ' ') {
+  struct BrokenText {
+    string text;
+    vector<string> lines;
+  };
+  static CallCache<BrokenText> cache(2000);
+  auto ret = cache.get([&renderer] (const string& text, int maxWidth, int size, char delim) {
+        return BrokenText{text, breakTextImpl(renderer, text, maxWidth, size, delim)};
+      }, 0, text, maxWidth, size, delim);
+  if (ret.text != text)
+    return breakTextImpl(renderer, text, maxWidth, size, delim);
+  return std::move(ret.lines);
+}
+
 vector<string> GuiFactory::breakText(const string& text, int maxWidth, int fontSize) {
   return ::breakText(renderer, text, maxWidth, fontSize);
 }
@@ -737,7 +764,7 @@ class LabelMultiLine : public GuiElem {
 
 SGuiElem GuiFactory::labelMultiLine(const TString& ts, int lineHeight, int size, Color c) {
   auto s = translate(ts);
-  return SGuiElem(new LabelMultiLine(s, lineHeight, size, c));
+  return makeGuiElem<LabelMultiLine>(s, lineHeight, size, c);
 }
 
 SGuiElem GuiFactory::labelMultiLineWidth(const TString& ts, int lineHeight, int width, int size, Color c, char delim) {
@@ -956,7 +983,7 @@ static Color blinkingColor(Color c1, Color c2, milliseconds time) {
 
 SGuiElem GuiFactory::labelHighlightBlink(const TString& ts, Color c1, Color c2, char hotkey) {
   auto s = translate(ts);
-  return SGuiElem(new DrawCustom(
+  return makeGuiElem<DrawCustom>(
         [=] (Renderer& r, Rectangle bounds) {
           Color c = blinkingColor(c1, c2, clock->getRealMillis());
           r.drawTextWithHotkey(Color::BLACK.transparency(100),
@@ -965,44 +992,44 @@ SGuiElem GuiFactory::labelHighlightBlink(const TString& ts, Color c1, Color c2,
           if (r.getMousePos().inRectangle(bounds))
             lighten(c1);
           r.drawTextWithHotkey(c1, bounds.topLeft(), s, hotkey);
-        }, renderer.getTextSize(s)));
+        }, renderer.getTextSize(s));
 }
 
 SGuiElem GuiFactory::label(const TString& ts, function<Color()> colorFun, char hotkey) {
   auto s = translate(ts);
-  return SGuiElem(new DrawCustom(
+  return makeGuiElem<DrawCustom>(
         [=] (Renderer& r, Rectangle bounds) {
           auto color = colorFun();
           r.drawText(Color::BLACK.transparency(min<Uint8>(100, color.a)), bounds.topLeft() + Vec2(1, 2), s);
           r.drawTextWithHotkey(colorFun(), bounds.topLeft(), s, hotkey);
-        }, renderer.getTextSize(s)));
+        }, renderer.getTextSize(s));
 }
 
 SGuiElem GuiFactory::labelFun(function<TString()> textFun, function<Color()> colorFun) {
-  return SGuiElem(new DrawCustom(
+  return makeGuiElem<DrawCustom>(
         [=] (Renderer& r, Rectangle bounds) {
           auto s = translate(textFun());
           r.drawText(Color::BLACK.transparency(100), bounds.topLeft() + Vec2(1, 2), s);
           r.drawText(colorFun(), bounds.topLeft(), s);
-        }));
+        });
 }
 
 SGuiElem GuiFactory::labelFun(function<TString()> textFun, Color color) {
-  return SGuiElem(new DrawCustom(
+  return makeGuiElem<DrawCustom>(
         [=] (Renderer& r, Rectangle bounds) {
           auto s = translate(textFun());
           r.drawText(Color::BLACK.transparency(100), bounds.topLeft() + Vec2(1, 2), s);
           r.drawText(color, bounds.topLeft(), s);
-        }));
+        });
 }
 
 SGuiElem GuiFactory::label(const TString& ts, int size, Color c) {
   auto s = translate(ts);
-  return SGuiElem(new DrawCustom(
+  return makeGuiElem<DrawCustom>(
         [=] (Renderer& r, Rectangle bounds) {
           r.drawText(Color::BLACK.transparency(100), bounds.topLeft() + Vec2(1, 2), s, Renderer::NONE, size);
           r.drawText(c, bounds.topLeft(), s, Renderer::NONE, size);
-        }, renderer.getTextSize(s, size)));
+        }, renderer.getTextSize(s, size));
 }
 
 static Vec2 getTextPos(Rectangle bounds, Renderer::CenterType center) {
@@ -1020,12 +1047,12 @@ static Vec2 getTextPos(Rectangle bounds, Renderer::CenterType center) {
 
 SGuiElem GuiFactory::centeredLabel(Renderer::CenterType center, const TString& ts, int size, Color c) {
   auto s = translate(ts);
-  return SGuiElem(new DrawCustom(
+  return makeGuiElem<DrawCustom>(
         [=] (Renderer& r, Rectangle bounds) {
           Vec2 pos = getTextPos(bounds, center);
           r.drawText(Color::BLACK.transparency(100), pos + Vec2(1, 2), s, center, size);
           r.drawText(c, pos, s, center, size);
-        }, renderer.getTextSize(s, size)));
+        }, renderer.getTextSize(s, size));
 }
 
 SGuiElem GuiFactory::centeredLabel(Renderer::CenterType center, const TString& s, Color c) {
@@ -1034,29 +1061,29 @@ SGuiElem GuiFactory::centeredLabel(Renderer::CenterType center, const TString& s
 
 SGuiElem GuiFactory::labelUnicode(const TString& ts, Color color, int size, FontId fontId) {
   auto s = translate(ts);
-  return SGuiElem(new DrawCustom(
+  return makeGuiElem<DrawCustom>(
         [=] (Renderer& r, Rectangle bounds) {
           r.drawText(fontId, size, color, bounds.topLeft(), s);
-  }, renderer.getTextSize(s, size, fontId)));
+  }, renderer.getTextSize(s, size, fontId));
 }
 
 SGuiElem GuiFactory::labelUnicodeHighlight(const TString& ts, Color color, int size, FontId fontId) {
   auto s = translate(ts);
-  return SGuiElem(new DrawCustom(
+  return makeGuiElem<DrawCustom>(
         [=] (Renderer& r, Rectangle bounds) {
           Color c = color;
           if (r.getMousePos().inRectangle(bounds))
             lighten(c);
           r.drawText(fontId, size, c, bounds.topLeft(), s);
-  }, renderer.getTextSize(s, size, fontId)));
+  }, renderer.getTextSize(s, size, fontId));
 }
 
 SGuiElem GuiFactory::crossOutText(Color color) {
-  return SGuiElem(new DrawCustom([=] (Renderer& r, Rectangle bounds) {
+  return makeGuiElem<DrawCustom>([=] (Renderer& r, Rectangle bounds) {
       Rectangle pos(bounds.left(), bounds.middle().y - 3, bounds.right(), bounds.middle().y - 1);
       r.drawFilledRectangle(pos.translate(Vec2(1, 2)), Color::BLACK.transparency(100));
       r.drawFilledRectangle(pos, color);
-  }));
+  });
 }
 
 class GuiLayout : public GuiElem {
@@ -1167,7 +1194,7 @@ class GuiStack : public GuiLayout {
 };
 
 SGuiElem GuiFactory::stack(vector<SGuiElem> elems) {
-  return SGuiElem(new GuiStack(std::move(elems)));
+  return makeGuiElem<GuiStack>(std::move(elems));
 }
 
 SGuiElem GuiFactory::stack(SGuiElem g1, SGuiElem g2) {
@@ -1223,7 +1250,7 @@ class Focusable : public GuiStack {
 };
 
 SGuiElem GuiFactory::focusable(SGuiElem content, Keybinding focusEvent, Keybinding defocusEvent, bool& focused) {
-  return SGuiElem(new Focusable(std::move(content), getKeybindingMap(), focusEvent, defocusEvent, focused));
+  return makeGuiElem<Focusable>(std::move(content), getKeybindingMap(), focusEvent, defocusEvent, focused);
 }
 
 class KeyHandler : public GuiElem {
@@ -1252,7 +1279,7 @@ class StopMouseMovement : public GuiElem {
 };
 
 SGuiElem GuiFactory::stopMouseMovement() {
-  return SGuiElem(new StopMouseMovement());
+  return makeGuiElem<StopMouseMovement>();
 }
 
 class StopScrollEvent : public GuiStack {
@@ -1269,11 +1296,11 @@ class StopScrollEvent : public GuiStack {
 };
 
 SGuiElem GuiFactory::stopScrollEvent(SGuiElem content, function<bool()> cond) {
-  return SGuiElem(new StopScrollEvent(std::move(content), std::move(cond)));
+  return makeGuiElem<StopScrollEvent>(std::move(content), std::move(cond));
 }
 
 SGuiElem GuiFactory::stopKeyEvents() {
-  return SGuiElem(new KeyHandler([](SDL_Keysym) {}, true));
+  return makeGuiElem<KeyHandler>([](SDL_Keysym) {}, true);
 }
 
 class RenderInBounds : public GuiStack {
@@ -1288,7 +1315,7 @@ class RenderInBounds : public GuiStack {
 };
 
 SGuiElem GuiFactory::renderInBounds(SGuiElem elem) {
-  return SGuiElem(new RenderInBounds(std::move(elem)));
+  return makeGuiElem<RenderInBounds>(std::move(elem));
 }
 
 class AlignmentGui : public GuiLayout {
@@ -1344,11 +1371,11 @@ class AlignmentGui : public GuiLayout {
 };
 
 SGuiElem GuiFactory::alignment(GuiFactory::Alignment alignment, SGuiElem content, optional<Vec2> size) {
-  return SGuiElem(new AlignmentGui(std::move(content), alignment, size));
+  return makeGuiElem<AlignmentGui>(std::move(content), alignment, size);
 }
 
 SGuiElem GuiFactory::keyHandler(function<void(SDL_Keysym)> fun, bool capture) {
-  return SGuiElem(new KeyHandler(fun, capture));
+  return makeGuiElem<KeyHandler>(fun, capture);
 }
 
 class KeybindingHandler : public GuiElem {
@@ -1380,22 +1407,22 @@ class KeybindingHandler : public GuiElem {
 };
 
 SGuiElem GuiFactory::keyHandler(function<void()> fun, Keybinding keybinding, bool capture) {
-  return SGuiElem(new KeybindingHandler(options->getKeybindingMap(), keybinding,
-      [fun = std::move(fun)](Rectangle) { fun(); }, capture));
+  return makeGuiElem<KeybindingHandler>(options->getKeybindingMap(), keybinding,
+      [fun = std::move(fun)](Rectangle) { fun(); }, capture);
 }
 
 SGuiElem GuiFactory::keyHandler(function<void()> fun, Keybinding keybinding, SoundId sound) {
-  return SGuiElem(new KeybindingHandler(options->getKeybindingMap(), keybinding,
-      [fun = std::move(fun)](Rectangle) { fun(); }, soundLibrary, sound));
+  return makeGuiElem<KeybindingHandler>(options->getKeybindingMap(), keybinding,
+      [fun = std::move(fun)](Rectangle) { fun(); }, soundLibrary, sound);
 }
 
 SGuiElem GuiFactory::keyHandlerRect(function<void(Rectangle)> fun, Keybinding keybinding, bool capture) {
-  return SGuiElem(new KeybindingHandler(options->getKeybindingMap(), keybinding, std::move(fun), capture));
+  return makeGuiElem<KeybindingHandler>(options->getKeybindingMap(), keybinding, std::move(fun), capture);
 }
 
 SGuiElem GuiFactory::keyHandlerRect(function<void(Rectangle)> fun, Keybinding keybinding, SoundId soundId) {
-  return SGuiElem(new KeybindingHandler(options->getKeybindingMap(), keybinding, std::move(fun), soundLibrary,
-      soundId));
+  return makeGuiElem<KeybindingHandler>(options->getKeybindingMap(), keybinding, std::move(fun), soundLibrary,
+      soundId);
 }
 
 KeybindingMap* GuiFactory::getKeybindingMap() {
@@ -1426,20 +1453,20 @@ class KeyHandler2 : public GuiElem {
 };
 
 SGuiElem GuiFactory::keyHandler(function<void()> fun, vector<SDL_Keysym> key, bool capture) {
-  return SGuiElem(new KeyHandler2([fun = std::move(fun)](Rectangle) { fun();}, key, capture));
+  return makeGuiElem<KeyHandler2>([fun = std::move(fun)](Rectangle) { fun();}, key, capture);
 }
 
 SGuiElem GuiFactory::keyHandlerBool(function<bool()> fun, vector<SDL_Keysym> key) {
-  return SGuiElem(new KeyHandler2([fun = std::move(fun)](Rectangle) { return fun();}, key));
+  return makeGuiElem<KeyHandler2>([fun = std::move(fun)](Rectangle) { return fun();}, key);
 }
 
 SGuiElem GuiFactory::keyHandlerBool(function<bool()> fun, Keybinding key) {
-  return SGuiElem(new KeybindingHandler(options->getKeybindingMap(), key,
-      [fun = std::move(fun)](Rectangle) { return fun();}));
+  return makeGuiElem<KeybindingHandler>(options->getKeybindingMap(), key,
+      [fun = std::move(fun)](Rectangle) { return fun();});
 }
 
 SGuiElem GuiFactory::keyHandlerRect(function<void(Rectangle)> fun, vector<SDL::SDL_Keysym> key, bool capture) {
-  return SGuiElem(new KeyHandler2(fun, key, capture));
+  return makeGuiElem<KeyHandler2>(fun, key, capture);
 }
 
 class ElemList : public GuiLayout {
@@ -1534,7 +1561,7 @@ class VerticalList : public ElemList {
 
 SGuiElem GuiFactory::verticalList(vector<SGuiElem> e, int height) {
   vector<int> heights(e.size(), height);
-  return SGuiElem(new VerticalList(std::move(e), heights, 0, false));
+  return makeGuiElem<VerticalList>(std::move(e), heights, 0, false);
 }
 
 class HorizontalList : public ElemList {
@@ -1561,7 +1588,7 @@ class HorizontalList : public ElemList {
 
 SGuiElem GuiFactory::horizontalList(vector<SGuiElem> e, int height) {
   vector<int> heights(e.size(), height);
-  return SGuiElem(new HorizontalList(std::move(e), heights, 0, false));
+  return makeGuiElem<HorizontalList>(std::move(e), heights, 0, false);
 }
 
 GuiFactory::ListBuilder GuiFactory::getListBuilder(int defaultSize) {
@@ -1656,7 +1683,7 @@ SGuiElem GuiFactory::ListBuilder::buildVerticalList() {
         sizes[i] = *elems[i]->getPreferredHeight();
     }
   }
-  auto ret = SGuiElem(new VerticalList(std::move(elems), sizes, backElems, middleElem));
+  auto ret = makeGuiElem<VerticalList>(std::move(elems), sizes, backElems, middleElem);
   if (lineNumber)
     ret->setLineNumber(*lineNumber);
   return ret;
@@ -1670,7 +1697,7 @@ SGuiElem GuiFactory::ListBuilder::buildHorizontalList() {
       else
         sizes[i] = *elems[i]->getPreferredWidth();
     }
-  auto ret = SGuiElem(new HorizontalList(std::move(elems), sizes, backElems, middleElem));
+  auto ret = makeGuiElem<HorizontalList>(std::move(elems), sizes, backElems, middleElem);
   if (lineNumber)
     ret->setLineNumber(*lineNumber);
   return ret;
@@ -1717,7 +1744,7 @@ class VerticalListFit : public GuiLayout {
 
 
 SGuiElem GuiFactory::verticalListFit(vector<SGuiElem> e, double spacing) {
-  return SGuiElem(new VerticalListFit(std::move(e), spacing));
+  return makeGuiElem<VerticalListFit>(std::move(e), spacing);
 }
 
 class HorizontalListFit : public GuiLayout {
@@ -1747,7 +1774,7 @@ class HorizontalListFit : public GuiLayout {
 
 
 SGuiElem GuiFactory::horizontalListFit(vector<SGuiElem> e, double spacing) {
-  return SGuiElem(new HorizontalListFit(std::move(e), spacing));
+  return makeGuiElem<HorizontalListFit>(std::move(e), spacing);
 }
 
 class VerticalAspect : public GuiLayout {
@@ -1766,7 +1793,7 @@ class VerticalAspect : public GuiLayout {
 };
 
 SGuiElem GuiFactory::verticalAspect(SGuiElem elem, double ratio) {
-  return SGuiElem(new VerticalAspect(std::move(elem), ratio));
+  return makeGuiElem<VerticalAspect>(std::move(elem), ratio);
 }
 
 class CenterHoriz : public GuiLayout {
@@ -1801,7 +1828,7 @@ class CenterHoriz : public GuiLayout {
 SGuiElem GuiFactory::centerHoriz(SGuiElem e, optional<int> width) {
   if (width && *width == 0)
     return empty();
-  return SGuiElem(new CenterHoriz(std::move(e), width));
+  return makeGuiElem<CenterHoriz>(std::move(e), width);
 }
 
 class CenterVert : public GuiLayout {
@@ -1829,7 +1856,7 @@ class CenterVert : public GuiLayout {
 SGuiElem GuiFactory::centerVert(SGuiElem e, optional<int> height) {
   if (height && *height == 0)
     return empty();
-  return SGuiElem(new CenterVert(std::move(e), height));
+  return makeGuiElem<CenterVert>(std::move(e), height);
 }
 
 class MarginGui : public GuiLayout {
@@ -1869,7 +1896,7 @@ class MarginGui : public GuiLayout {
 };
 
 SGuiElem GuiFactory::margin(SGuiElem top, SGuiElem rest, int width, MarginType type) {
-  return SGuiElem(new MarginGui(std::move(top), std::move(rest), width, type));
+  return makeGuiElem<MarginGui>(std::move(top), std::move(rest), width, type);
 }
 
 SGuiElem GuiFactory::marginAuto(SGuiElem top, SGuiElem rest, MarginType type) {
@@ -1880,7 +1907,7 @@ SGuiElem GuiFactory::marginAuto(SGuiElem top, SGuiElem rest, MarginType type) {
     case MarginType::TOP:
     case MarginType::BOTTOM: width = *top->getPreferredHeight(); break;
   }
-  return SGuiElem(new MarginGui(std::move(top), std::move(rest), width, type));
+  return makeGuiElem<MarginGui>(std::move(top), std::move(rest), width, type);
 }
 
 class MaybeMargin : public MarginGui {
@@ -1905,7 +1932,7 @@ class MaybeMargin : public MarginGui {
 
 SGuiElem GuiFactory::maybeMargin(SGuiElem top, SGuiElem rest, int width, MarginType type,
     function<bool(Rectangle)> pred) {
-  return SGuiElem(new MaybeMargin(std::move(top), std::move(rest), width, type, pred));
+  return makeGuiElem<MaybeMargin>(std::move(top), std::move(rest), width, type, pred);
 }
 
 class FullScreen : public GuiLayout {
@@ -1926,7 +1953,7 @@ class FullScreen : public GuiLayout {
 };
 
 SGuiElem GuiFactory::fullScreen(SGuiElem content) {
-  return SGuiElem(new FullScreen(std::move(content), renderer));
+  return makeGuiElem<FullScreen>(std::move(content), renderer);
 }
 
 class AbsolutePosition : public GuiLayout {
@@ -1953,7 +1980,7 @@ class AbsolutePosition : public GuiLayout {
 };
 
 SGuiElem GuiFactory::absolutePosition(SGuiElem content, Vec2 pos) {
-  return SGuiElem(new AbsolutePosition(std::move(content), pos, renderer));
+  return makeGuiElem<AbsolutePosition>(std::move(content), pos, renderer);
 }
 
 class MarginFit : public GuiLayout {
@@ -1995,16 +2022,16 @@ class MarginFit : public GuiLayout {
 };
 
 SGuiElem GuiFactory::marginFit(SGuiElem top, SGuiElem rest, double width, MarginType type) {
-  return SGuiElem(new MarginFit(std::move(top), std::move(rest), width, type));
+  return makeGuiElem<MarginFit>(std::move(top), std::move(rest), width, type);
 }
 
 SGuiElem GuiFactory::progressBar(Color c, double state) {
-  return SGuiElem(new DrawCustom([=] (Renderer& r, Rectangle bounds) {
+  return makeGuiElem<DrawCustom>([=] (Renderer& r, Rectangle bounds) {
           int width = bounds.width() * state;
           if (width > 0)
             r.drawFilledRectangle(Rectangle(bounds.topLeft(),
                   Vec2(bounds.left() + width, bounds.bottom())), c);
-        }));
+        });
 }
 
 class Margins : public GuiLayout {
@@ -2039,27 +2066,27 @@ class Margins : public GuiLayout {
 };
 
 SGuiElem GuiFactory::margins(SGuiElem content, int left, int top, int right, int bottom) {
-  return SGuiElem(new Margins(std::move(content), left, top, right, bottom));
+  return makeGuiElem<Margins>(std::move(content), left, top, right, bottom);
 }
 
 SGuiElem GuiFactory::margins(SGuiElem content, int all) {
-  return SGuiElem(new Margins(std::move(content), all, all, all, all));
+  return makeGuiElem<Margins>(std::move(content), all, all, all, all);
 }
 
 SGuiElem GuiFactory::leftMargin(int size, SGuiElem content) {
-  return SGuiElem(new Margins(std::move(content), size, 0, 0, 0));
+  return makeGuiElem<Margins>(std::move(content), size, 0, 0, 0);
 }
 
 SGuiElem GuiFactory::rightMargin(int size, SGuiElem content) {
-  return SGuiElem(new Margins(std::move(content), 0, 0, size, 0));
+  return makeGuiElem<Margins>(std::move(content), 0, 0, size, 0);
 }
 
 SGuiElem GuiFactory::topMargin(int size, SGuiElem content) {
-  return SGuiElem(new Margins(std::move(content), 0, size, 0, 0));
+  return makeGuiElem<Margins>(std::move(content), 0, size, 0, 0);
 }
 
 SGuiElem GuiFactory::bottomMargin(int size, SGuiElem content) {
-  return SGuiElem(new Margins(std::move(content), 0, 0, 0, size));
+  return makeGuiElem<Margins>(std::move(content), 0, 0, 0, size);
 }
 
 class Invisible : public GuiStack {
@@ -2072,7 +2099,7 @@ class Invisible : public GuiStack {
 };
 
 SGuiElem GuiFactory::invisible(SGuiElem content) {
-  return SGuiElem(new Invisible(std::move(content)));
+  return makeGuiElem<Invisible>(std::move(content));
 }
 
 class Switchable : public GuiLayout {
@@ -2118,23 +2145,23 @@ class PreferredSize : public GuiLayout {
 }
 
 SGuiElem GuiFactory::preferredSize(int width, int height, SGuiElem elem) {
-  return SGuiElem(new PreferredSize(std::move(elem), width, height));
+  return makeGuiElem<PreferredSize>(std::move(elem), width, height);
 }
 
 SGuiElem GuiFactory::preferredSize(Vec2 size, SGuiElem elem) {
-  return SGuiElem(new PreferredSize(std::move(elem), size.x, size.y));
+  return makeGuiElem<PreferredSize>(std::move(elem), size.x, size.y);
 }
 
 SGuiElem GuiFactory::setHeight(int height, SGuiElem content) {
-  return SGuiElem(new PreferredSize(std::move(content), none, height));
+  return makeGuiElem<PreferredSize>(std::move(content), none, height);
 }
 
 SGuiElem GuiFactory::setWidth(int width, SGuiElem content) {
-  return SGuiElem(new PreferredSize(std::move(content), width, none));
+  return makeGuiElem<PreferredSize>(std::move(content), width, none);
 }
 
 SGuiElem GuiFactory::empty() {
-  return SGuiElem(new PreferredSize(SGuiElem(new GuiElem()), 1, 1));
+  return makeGuiElem<PreferredSize>(makeGuiElem<GuiElem>(), 1, 1);
 }
 
 class ViewObjectGui : public GuiElem {
@@ -2182,28 +2209,28 @@ class ViewObjectGui : public GuiElem {
 };
 
 SGuiElem GuiFactory::viewObject(const ViewObject& object, double scale, Color color) {
-  return SGuiElem(new ViewObjectGui(object, Vec2(1, 1) * Renderer::nominalSize * scale, scale, color));
+  return makeGuiElem<ViewObjectGui>(object, Vec2(1, 1) * Renderer::nominalSize * scale, scale, color);
 }
 
 SGuiElem GuiFactory::viewObject(ViewId id, double scale, Color color) {
-  return SGuiElem(new ViewObjectGui({id}, Vec2(1, 1) * Renderer::nominalSize * scale, scale, color));
+  return makeGuiElem<ViewObjectGui>(ViewIdList{id}, Vec2(1, 1) * Renderer::nominalSize * scale, scale, color);
 }
 
 SGuiElem GuiFactory::viewObject(ViewIdList list, double scale, Color color) {
-  return SGuiElem(new ViewObjectGui(list, Vec2(1, 1) * Renderer::nominalSize * scale, scale, color));
+  return makeGuiElem<ViewObjectGui>(list, Vec2(1, 1) * Renderer::nominalSize * scale, scale, color);
 }
 
 SGuiElem GuiFactory::viewObject(function<ViewId()> id, double scale, Color color) {
-  return SGuiElem(new ViewObjectGui(std::move(id), Vec2(1, 1) * Renderer::nominalSize * scale, scale, color));
+  return makeGuiElem<ViewObjectGui>(std::move(id), Vec2(1, 1) * Renderer::nominalSize * scale, scale, color);
 }
 
 SGuiElem GuiFactory::viewObject(function<ViewObject()> id, double scale, Color color) {
-  return SGuiElem(new ViewObjectGui(std::move(id), Vec2(1, 1) * Renderer::nominalSize * scale, scale, color));
+  return makeGuiElem<ViewObjectGui>(std::move(id), Vec2(1, 1) * Renderer::nominalSize * scale, scale, color);
 }
 
 SGuiElem GuiFactory::asciiBackground(ViewId id) {
-  return SGuiElem(
-      new DrawCustom([=] (Renderer& renderer, Rectangle bounds) { renderer.drawAsciiBackground(id, bounds);}));
+  return makeGuiElem<DrawCustom>(
+      [=] (Renderer& renderer, Rectangle bounds) { renderer.drawAsciiBackground(id, bounds);});
 }
 
 class DragSource : public GuiElem {
@@ -2237,14 +2264,14 @@ class OnMouseRelease : public GuiElem {
 };
 
 SGuiElem GuiFactory::dragSource(DragContent content, function<SGuiElem()> gui) {
-  return SGuiElem(new DragSource(dragContainer, content, gui));
+  return makeGuiElem<DragSource>(dragContainer, content, gui);
 }
 
 SGuiElem GuiFactory::dragListener(function<void(DragContent)> fun) {
-  return SGuiElem(new OnMouseRelease([this, fun] {
+  return makeGuiElem<OnMouseRelease>([this, fun] {
         if (auto content = dragContainer.pop())
           fun(*content);
-      }));
+      });
 }
 
 class TranslateGui : public GuiLayout {
@@ -2292,7 +2319,7 @@ class TranslateGui : public GuiLayout {
 };
 
 SGuiElem GuiFactory::translate(SGuiElem e, Vec2 pos, optional<Vec2> size, TranslateCorner corner) {
-  return SGuiElem(new TranslateGui(std::move(e), pos, size, corner));
+  return makeGuiElem<TranslateGui>(std::move(e), pos, size, corner);
 }
 
 class TranslateGui2 : public GuiLayout {
@@ -2309,7 +2336,7 @@ class TranslateGui2 : public GuiLayout {
 };
 
 SGuiElem GuiFactory::translate(function<Vec2()> f, SGuiElem e) {
-  return SGuiElem(new TranslateGui2(std::move(e), f));
+  return makeGuiElem<TranslateGui2>(std::move(e), f);
 }
 
 class TranslateAbsolute : public GuiLayout {
@@ -2327,11 +2354,11 @@ class TranslateAbsolute : public GuiLayout {
 };
 
 SGuiElem GuiFactory::translateAbsolute(function<Vec2()> f, SGuiElem elem) {
-  return SGuiElem(new TranslateAbsolute(std::move(elem), std::move(f)));
+  return makeGuiElem<TranslateAbsolute>(std::move(elem), std::move(f));
 }
 
 SGuiElem GuiFactory::onRenderedAction(function<void()> fun) {
-  return SGuiElem(new DrawCustom([=] (Renderer& r, Rectangle bounds) { fun(); }));
+  return makeGuiElem<DrawCustom>([=] (Renderer& r, Rectangle bounds) { fun(); });
 }
 
 class MouseOverAction : public GuiElem {
@@ -2366,7 +2393,7 @@ class MouseOverAction : public GuiElem {
 };
 
 SGuiElem GuiFactory::mouseOverAction(function<void()> callback, function<void()> outCallback) {
-  return SGuiElem(new MouseOverAction(callback, outCallback));
+  return makeGuiElem<MouseOverAction>(callback, outCallback);
 }
 
 class MouseButtonHeld : public GuiStack {
@@ -2401,11 +2428,11 @@ class MouseButtonHeld : public GuiStack {
 };
 
 SGuiElem GuiFactory::onMouseLeftButtonHeld(SGuiElem elem) {
-  return SGuiElem(new MouseButtonHeld(std::move(elem), MouseButtonId::LEFT));
+  return makeGuiElem<MouseButtonHeld>(std::move(elem), MouseButtonId::LEFT);
 }
 
 SGuiElem GuiFactory::onMouseRightButtonHeld(SGuiElem elem) {
-  return SGuiElem(new MouseButtonHeld(std::move(elem), MouseButtonId::RIGHT));
+  return makeGuiElem<MouseButtonHeld>(std::move(elem), MouseButtonId::RIGHT);
 }
 
 class MouseHighlightBase : public GuiStack {
@@ -2475,11 +2502,11 @@ class MouseHighlight2 : public GuiStack {
 };
 
 SGuiElem GuiFactory::mouseHighlight(SGuiElem elem, int myIndex, optional<int>* highlighted) {
-  return SGuiElem(new MouseHighlight(std::move(elem), myIndex, highlighted));
+  return makeGuiElem<MouseHighlight>(std::move(elem), myIndex, highlighted);
 }
 
 SGuiElem GuiFactory::mouseHighlight2(SGuiElem elem, SGuiElem noHighlight, bool capture) {
-  return SGuiElem(new MouseHighlight2(std::move(elem), std::move(noHighlight), capture));
+  return makeGuiElem<MouseHighlight2>(std::move(elem), std::move(noHighlight), capture);
 }
 
 class RenderLayer : public GuiStack {
@@ -2494,7 +2521,7 @@ class RenderLayer : public GuiStack {
 };
 
 SGuiElem GuiFactory::renderTopLayer(SGuiElem content) {
-  return make_shared<RenderLayer>(std::move(content));
+  return makeGuiElem<RenderLayer>(std::move(content));
 }
 
 class Tooltip2 : public GuiElem {
@@ -2532,7 +2559,7 @@ class Tooltip2 : public GuiElem {
 };
 
 SGuiElem GuiFactory::tooltip2(SGuiElem elem, PositionFun positionFun) {
-  return SGuiElem(new Tooltip2(std::move(elem), positionFun));
+  return makeGuiElem<Tooltip2>(std::move(elem), positionFun);
 }
 
 const static int tooltipLineHeight = 28;
@@ -2590,7 +2617,7 @@ SGuiElem GuiFactory::tooltip(const vector<TString>& v, milliseconds delayMilli)
   vector<string> tv;
   for (auto& elem : v)
     tv.append(breakText(translate(elem), 500, Renderer::textSize()));
-  return SGuiElem(new Tooltip(std::move(tv), stack(background(background1), miniBorder()), clock, delayMilli));
+  return makeGuiElem<Tooltip>(std::move(tv), stack(background(background1), miniBorder()), clock, delayMilli);
 }
 namespace {
 class ScrollArea : public GuiElem {
@@ -2669,7 +2696,7 @@ class ScrollArea : public GuiElem {
 }
 
 SGuiElem GuiFactory::scrollArea(SGuiElem elem, pair<double, double>& scrollPos) {
-  return make_shared<ScrollArea>(std::move(elem), scrollPos);
+  return makeGuiElem<ScrollArea>(std::move(elem), scrollPos);
 }
 
 const static int notHeld = -1000;
@@ -2935,11 +2962,11 @@ class Conditional : public GuiStack {
 }
 
 SGuiElem GuiFactory::conditional(SGuiElem elem, function<bool()> f) {
-  return SGuiElem(new Conditional(std::move(elem), [f](GuiElem*) { return f(); }));
+  return makeGuiElem<Conditional>(std::move(elem), [f](GuiElem*) { return f(); });
 }
 
 SGuiElem GuiFactory::conditional(function<int()> f, vector<SGuiElem> elem) {
-  return SGuiElem(new Conditional(std::move(elem), [f](GuiElem*) { return f(); }));
+  return makeGuiElem<Conditional>(std::move(elem), [f](GuiElem*) { return f(); });
 }
 
 namespace {
@@ -2958,15 +2985,15 @@ class ConditionalStopKeys : public Conditional {
 }
 
 SGuiElem GuiFactory::conditionalStopKeys(SGuiElem elem, function<bool()> f) {
-  return SGuiElem(new ConditionalStopKeys(std::move(elem), [f](GuiElem*) { return f(); }));
+  return makeGuiElem<ConditionalStopKeys>(std::move(elem), [f](GuiElem*) { return f(); });
 }
 
 SGuiElem GuiFactory::conditional2(SGuiElem elem, function<bool(GuiElem*)> f) {
-  return SGuiElem(new Conditional(std::move(elem), f));
+  return makeGuiElem<Conditional>(std::move(elem), f);
 }
 
 SGuiElem GuiFactory::conditional2(SGuiElem elem, SGuiElem alter, function<bool(GuiElem*)> f) {
-  return SGuiElem(new Conditional(makeVec(std::move(elem), std::move(alter)), [f](GuiElem* e){ return f(e) ? 0 : 1; }));
+  return makeGuiElem<Conditional>(makeVec(std::move(elem), std::move(alter)), [f](GuiElem* e){ return f(e) ? 0 : 1; });
 }
 
 SGuiElem GuiFactory::conditional(SGuiElem elem, SGuiElem alter, function<bool()> f) {
@@ -2982,14 +3009,14 @@ const int scrollbarWidth = 22;
 
 SGuiElem GuiFactory::scrollable(SGuiElem content, ScrollPosition* scrollPos, int* held, int topMargin) {
   if (!scrollPos) {
-    auto cont = new GuiContainScrollPos();
+    auto cont = makeGuiElem<GuiContainScrollPos>();
     scrollPos = &cont->pos;
-    content = stack(SGuiElem(cont), std::move(content));
+    content = stack(std::move(cont), std::move(content));
   }
-  SGuiElem scrollable(new Scrollable(content, scrollPos, clock, topMargin));
+  SGuiElem scrollable = makeGuiElem<Scrollable>(content, scrollPos, clock, topMargin);
   int scrollBarMargin = get(TexId::SCROLL_UP).getSize().y;
-  SGuiElem bar(new ScrollBar(
-        getScrollButton(), content, getScrollButtonSize(), scrollBarMargin, scrollPos, held, clock));
+  SGuiElem bar = makeGuiElem<ScrollBar>(
+        getScrollButton(), content, getScrollButtonSize(), scrollBarMargin, scrollPos, held, clock);
   SGuiElem barButtons = getScrollbar();
   barButtons = conditional2(std::move(barButtons), [=] (GuiElem* e) {
       return e->getBounds().height() < *content->getPreferredHeight();});
@@ -3203,7 +3230,7 @@ class TextInputElem : public GuiElem {
 }
 
 SGuiElem GuiFactory::textInput(int width, int maxLines, shared_ptr<string> text) {
-  return make_shared<TextInputElem>(width, maxLines, text);
+  return makeGuiElem<TextInputElem>(width, maxLines, text);
 }
 
 SGuiElem GuiFactory::minimapBar(SGuiElem icon1, SGuiElem icon2) {
@@ -24,6 +24,7 @@
 #include "view_id.h"
 #include "keybinding.h"
 #include "steam_input.h"
+#include "frame_arena.h"
 
 class ViewObject;
 class TString;
@@ -69,6 +70,15 @@ class GuiElem {
   optional<int> lineNumber;
 };
 
+// Elements made while a FrameArena::Scope is active are allocated, together with their reference counts, in
+// that arena.
+template <typename T, typename... Args>
+shared_ptr<T> makeGuiElem(Args&&... args) {
+  if (auto arena = FrameArena::getCurrent())
+    return std::allocate_shared<T>(FrameAllocator<T>(arena), std::forward<Args>(args)...);
+  return make_shared<T>(std::forward<Args>(args)...);
+}
+
 class GuiFactory {
   public:
   GuiFactory(Renderer&, Clock*, Options*, Translations*, SoundLibrary*, const DirectoryPath& freeDataPath);
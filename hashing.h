@@ -2,6 +2,7 @@
 
 #include "stdafx.h"
 #include "my_containers.h"
+#include "flat_hash.h"
 
 struct general_ {};
 struct special_ : general_ {};
@@ -6,3 +6,5 @@ class ItemListId : public ContentId<ItemListId> {
   public:
   using ContentId::ContentId;
 };
+
+CEREAL_CLASS_VERSION(ItemListId, 1)
@@ -7,3 +7,5 @@ class Keybinding : public ContentId<Keybinding> {
   public:
   using ContentId::ContentId;
 };
+
+CEREAL_CLASS_VERSION(Keybinding, 1)
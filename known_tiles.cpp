@@ -4,7 +4,12 @@
 
 template <class Archive>
 void KnownTiles::serialize(Archive& ar, const unsigned int version) {
-  ar(known, border);
+  if (Archive::is_loading::value && version == 0) {
+    PositionSet oldKnown;
+    ar(oldKnown, border);
+    known = DensePositionSet(oldKnown);
+  } else
+    ar(known, border);
 }
 
 SERIALIZABLE(KnownTiles);
@@ -27,7 +32,7 @@ const PositionSet& KnownTiles::getBorderTiles() const {
   return border;
 }
 
-const PositionSet& KnownTiles::getAll() const {
+const DensePositionSet& KnownTiles::getAll() const {
   return known;
 }
 
@@ -35,17 +40,14 @@ bool KnownTiles::isKnown(Position pos) const {
   return known.count(pos);
 };
 
-static void limitToModel(PositionSet& s, const Model* m) {
+void KnownTiles::limitToModel(const Model* m) {
+  known.limitToModel(m);
   PositionSet copy;
-  for (auto& p : s)
+  for (auto& p : border)
     if (p.getModel() == m)
       copy.insert(p);
-  s = copy;
-}
-
-void KnownTiles::limitToModel(const Model* m) {
-  ::limitToModel(known, m);
-  ::limitToModel(border, m);
+  border = copy;
+  knownWithMargin = none;
 }
 
 void KnownTiles::limitBorderTiles(Model* m) {
@@ -56,12 +58,8 @@ void KnownTiles::limitBorderTiles(Model* m) {
   border = copy;
 }
 
-const PositionSet& KnownTiles::getKnownTilesWithMargin() {
-  if (!knownWithMargin) {
-    knownWithMargin = known;
-    for (auto& v : known)
-      for (auto neighbour : v.neighbors8())
-        knownWithMargin->insert(neighbour);
-  }
+const DensePositionSet& KnownTiles::getKnownTilesWithMargin() {
+  if (!knownWithMargin)
+    knownWithMargin = known.withMargin();
   return *knownWithMargin;
 }
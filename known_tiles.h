@@ -16,23 +16,26 @@
 
 #include "util.h"
 #include "position_map.h"
+#include "dense_position_set.h"
 
 class KnownTiles {
   public:
   void addTile(Position, Model* borderTilesModel);
   bool isKnown(Position) const;
   const PositionSet& getBorderTiles() const;
-  const PositionSet& getAll() const;
+  const DensePositionSet& getAll() const;
   void limitToModel(const Model*);
   void limitBorderTiles(Model*);
-  const PositionSet& getKnownTilesWithMargin();
+  const DensePositionSet& getKnownTilesWithMargin();
 
   template <class Archive> 
   void serialize(Archive& ar, const unsigned int version);
 
   private:
-  PositionSet SERIAL(known);
+  DensePositionSet SERIAL(known);
   PositionSet SERIAL(border);
-  optional<PositionSet> knownWithMargin;
+  optional<DensePositionSet> knownWithMargin;
 };
 
+CEREAL_CLASS_VERSION(KnownTiles, 1)
+
@@ -0,0 +1,127 @@
+#include "stdafx.h"
+#include "layout_canvas.h"
+#include "pretty_archive.h"
+
+static vector<string>& getNames() {
+  static vector<string> names {""};
+  return names;
+}
+
+static unordered_map<string, LayoutToken::Id>& getIds() {
+  static unordered_map<string, LayoutToken::Id> ids {{"", 0}};
+  return ids;
+}
+
+LayoutToken::LayoutToken() : id(0) {
+}
+
+LayoutToken::LayoutToken(const string& name) {
+  auto& ids = getIds();
+  if (auto ret = getReferenceMaybe(ids, name))
+    id = *ret;
+  else {
+    auto& names = getNames();
+    USER_CHECK(names.size() <= std::numeric_limits<Id>::max()) << "Too many layout tokens";
+    id = Id(names.size());
+    ids[name] = id;
+    names.push_back(name);
+  }
+}
+
+const string& LayoutToken::data() const {
+  return getNames()[id];
+}
+
+int LayoutToken::getNumTokens() {
+  return getNames().size();
+}
+
+void LayoutToken::serialize(PrettyInputArchive& ar) {
+  string name;
+  ar(name);
+  *this = LayoutToken(name);
+}
+
+static std::uint64_t getMaskBit(LayoutToken token) {
+  return std::uint64_t(1) << (token.getId() % 64);
+}
+
+bool LayoutTile::contains(LayoutToken token) const {
+  if (!(mask & getMaskBit(token)))
+    return false;
+  for (auto elem : *this)
+    if (elem == token)
+      return true;
+  return false;
+}
+
+void LayoutTile::insert(int index, LayoutToken token) {
+  mask |= getMaskBit(token);
+  if (numTokens < inlineCapacity) {
+    for (int i = numTokens; i > index; --i)
+      inlineTokens[i] = inlineTokens[i - 1];
+    inlineTokens[index] = token;
+  } else {
+    if (numTokens == inlineCapacity) {
+      overflow.clear();
+      overflow.append(inlineTokens, inlineTokens + inlineCapacity);
+    }
+    overflow.insert(index, token);
+  }
+  ++numTokens;
+}
+
+void LayoutTile::add(LayoutToken token) {
+  if (!contains(token))
+    insert(numTokens, token);
+}
+
+void LayoutTile::addFront(LayoutToken token) {
+  if (!contains(token))
+    insert(0, token);
+}
+
+void LayoutTile::remove(LayoutToken token) {
+  if (!(mask & getMaskBit(token)))
+    return;
+  int index = 0;
+  while (index < numTokens && begin()[index] != token)
+    ++index;
+  if (index == numTokens)
+    return;
+  if (numTokens > inlineCapacity) {
+    overflow.removeIndexPreserveOrder(index);
+    if (numTokens - 1 == inlineCapacity) {
+      std::copy(overflow.begin(), overflow.end(), inlineTokens);
+      overflow.clear();
+    }
+  } else
+    for (int i = index; i < numTokens - 1; ++i)
+      inlineTokens[i] = inlineTokens[i + 1];
+  --numTokens;
+  mask = 0;
+  for (auto elem : *this)
+    mask |= getMaskBit(elem);
+}
+
+void LayoutTile::clear() {
+  mask = 0;
+  numTokens = 0;
+  overflow.clear();
+}
+
+bool LayoutTile::empty() const {
+  return numTokens == 0;
+}
+
+int LayoutTile::size() const {
+  return numTokens;
+}
+
+const LayoutToken* LayoutTile::begin() const {
+  return numTokens > inlineCapacity ? overflow.data() : inlineTokens;
+}
+
+const LayoutToken* LayoutTile::end() const {
+  return begin() + numTokens;
+}
@@ -3,11 +3,71 @@
 #include "stdafx.h"
 #include "util.h"
 
-using Token = string;
+class PrettyInputArchive;
+
+// Layout generators refer to tokens by name. The names are interned when the generators are loaded,
+// so that generating a layout only compares small integers.
+class LayoutToken {
+  public:
+  using Id = std::uint16_t;
+  LayoutToken();
+  explicit LayoutToken(const string&);
+  const string& data() const;
+  Id getId() const {
+    return id;
+  }
+  bool operator == (LayoutToken o) const {
+    return id == o.id;
+  }
+  bool operator != (LayoutToken o) const {
+    return id != o.id;
+  }
+  static int getNumTokens();
+
+  template <class Archive>
+  void serialize(Archive& ar) {
+    if (Archive::is_loading::value) {
+      string name;
+      ar(name);
+      *this = LayoutToken(name);
+    } else {
+      string name = data();
+      ar(name);
+    }
+  }
+  void serialize(PrettyInputArchive&);
+
+  private:
+  Id id;
+};
+
+// The tokens of a single tile, in the order in which they were set. A tile usually has just a few of them,
+// so they are kept inline and only move to the heap when there are more. The mask has the bit of every
+// token id modulo 64 set, which answers most lookups without looking at the tokens.
+class LayoutTile {
+  public:
+  bool contains(LayoutToken) const;
+  void add(LayoutToken);
+  void addFront(LayoutToken);
+  void remove(LayoutToken);
+  void clear();
+  bool empty() const;
+  int size() const;
+  const LayoutToken* begin() const;
+  const LayoutToken* end() const;
+
+  private:
+  void insert(int index, LayoutToken);
+  static constexpr int inlineCapacity = 6;
+  std::uint64_t mask = 0;
+  int numTokens = 0;
+  LayoutToken inlineTokens[inlineCapacity];
+  vector<LayoutToken> overflow;
+};
 
 struct LayoutCanvas {
   struct Map {
-    Table<vector<Token>> elems;
+    Table<LayoutTile> elems;
   };
   LayoutCanvas with(Rectangle area) const {
     USER_CHECK(map->elems.getBounds().contains(area)) << "Level generator exceeded map bounds. " << map->elems.getBounds() << " and " << area;
@@ -13,24 +13,22 @@ bool make(const LayoutGenerators::Fail&, LayoutCanvas c, RandomGen&) {
 
 bool make(const LayoutGenerators::Set& g, LayoutCanvas c, RandomGen&) {
   for (auto v : c.area)
-    for (auto& token : g.tokens)
-      if (!c.map->elems[v].contains(token))
-        c.map->elems[v].push_back(token);
+    for (auto token : g.tokens)
+      c.map->elems[v].add(token);
   return true;
 }
 
 bool make(const LayoutGenerators::SetFront& g, LayoutCanvas c, RandomGen&) {
   for (auto v : c.area)
-    if (!c.map->elems[v].contains(g.token))
-      c.map->elems[v].push_front(g.token);
+    c.map->elems[v].addFront(g.token);
   return true;
 }
 
 bool make(const LayoutGenerators::Reset& g, LayoutCanvas c, RandomGen&) {
   for (auto v : c.area) {
     c.map->elems[v].clear();
-    for (auto& token : g.tokens)
-      c.map->elems[v].push_back(token);
+    for (auto token : g.tokens)
+      c.map->elems[v].add(token);
   }
   return true;
 }
@@ -48,8 +46,8 @@ bool make(const LayoutGenerators::Filter& g, LayoutCanvas c, RandomGen& r) {
 
 bool make(const LayoutGenerators::Remove& g, LayoutCanvas c, RandomGen&) {
   for (auto v : c.area)
-    for (auto& token : g.tokens)
-      c.map->elems[v].removeElementMaybePreserveOrder(token);
+    for (auto token : g.tokens)
+      c.map->elems[v].remove(token);
   return true;
 }
 
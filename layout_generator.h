@@ -5,10 +5,9 @@
 #include "pretty_archive.h"
 #include "tile_predicate.h"
 
-struct LayoutGenerator;
-struct LayoutCanvas;
+#include "layout_canvas.h"
 
-using Token = string;
+struct LayoutGenerator;
 
 namespace LayoutGenerators {
   enum class MarginType;
@@ -26,17 +25,17 @@ struct None {
 };
 
 struct Set {
-  vector<Token> SERIAL(tokens);
+  vector<LayoutToken> SERIAL(tokens);
   SERIALIZE_ALL(withRoundBrackets(tokens))
 };
 
 struct SetFront {
-  Token SERIAL(token);
+  LayoutToken SERIAL(token);
   SERIALIZE_ALL(roundBracket(), NAMED(token))
 };
 
 struct Reset {
-  vector<Token> SERIAL(tokens);
+  vector<LayoutToken> SERIAL(tokens);
   SERIALIZE_ALL(withRoundBrackets(tokens))
 };
 
@@ -48,7 +47,7 @@ struct Filter {
 };
 
 struct Remove {
-  vector<Token> SERIAL(tokens);
+  vector<LayoutToken> SERIAL(tokens);
   SERIALIZE_ALL(withRoundBrackets(tokens))
 };
 
@@ -6,3 +6,5 @@ class LayoutMappingId : public ContentId<LayoutMappingId> {
   public:
   using ContentId::ContentId;
 };
+
+CEREAL_CLASS_VERSION(LayoutMappingId, 1)
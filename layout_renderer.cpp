@@ -6,6 +6,7 @@
 #include "layout_generator.h"
 #include "random_layout_id.h"
 #include "content_factory.h"
+#include "clock.h"
 
 string getColorCode(const string& color, const string& c) {
   auto number = [&] () -> string {
@@ -66,12 +67,12 @@ void renderAscii(const LayoutCanvas::Map& map1, istream& file) {
     for (auto x : map1.elems.getBounds().getXRange()) {
       auto& elems = map1.elems[x][y];
       if (!elems.empty()) {
-        auto glyph = chooseBest(elems, [&](const Token& t) {
-          if (priority.count(t))
-            return -priority.at(t);
+        auto glyph = chooseBest(elems, [&](LayoutToken t) {
+          if (priority.count(t.data()))
+            return -priority.at(t.data());
           else
             return 10000;
-        });
+        }).data();
         if (tokens.count(glyph)) {
           std::cerr << tokens.at(glyph);
           continue;
@@ -94,7 +95,10 @@ void generateMapLayout(const MainLoop& mainLoop, const string& layoutName, FileP
   auto factory = mainLoop.createContentFactory(false);
   USER_CHECK(factory.randomLayouts.count(RandomLayoutId(layoutName.data()))) << "Layout not found: " << layoutName;
   auto generator = factory.randomLayouts.at(RandomLayoutId(layoutName.data()));
-  LayoutCanvas::Map map{ Table<vector<Token>>(layoutSize) };
+  LayoutCanvas::Map map{ Table<LayoutTile>(layoutSize) };
+  auto startTime = Clock::getRealMicros();
   USER_CHECK(!!generator.make(LayoutCanvas{map.elems.getBounds(), &map}, Random)) << "Generation failed";
+  std::cerr << "Generated " << layoutName << " in " << (Clock::getRealMicros() - startTime).count() / 1000 << " msec"
+      << std::endl;
   renderAscii(map, glyphFile);
 }
@@ -49,6 +49,8 @@
 #include "portals.h"
 #include "effect_type.h"
 #include "content_factory.h"
+#include "light_engine.h"
+#include "perception_cache.h"
 
 template <class Archive>
 void Level::serialize(Archive& ar, const unsigned int version) {
@@ -56,8 +58,18 @@ void Level::serialize(Archive& ar, const unsigned int version) {
     CHECK(!model->serializationLocked);
   ar & SUBCLASS(OwnedObject<Level>);
   ar(squares, landingSquares, tickingSquares, creatures, model, fieldOfView);
-  ar(sunlight, bucketMap, lightAmount, unavailable, swarmMaps, territory);
-  ar(levelId, noDiagonalPassing, lightCapAmount, creatureIds, memoryUpdates, above, below, mountainLevel, furniture);
+  Table<double> lightAmount(0, 0);
+  Table<double> lightCapAmount(0, 0);
+  ar(sunlight, bucketMap);
+  if (version >= 2)
+    ar(lightEngine);
+  else
+    ar(lightAmount);
+  ar(unavailable, swarmMaps, territory, levelId, noDiagonalPassing);
+  // Older saves stored the summed up amounts, which are recomputed from the sources below.
+  if (version < 2)
+    ar(lightCapAmount);
+  ar(creatureIds, memoryUpdates, above, below, mountainLevel, furniture);
   if (version == 0) {
     set<Vec2> SERIAL(tickingFurniture);
     ar(tickingFurniture);
@@ -79,6 +91,15 @@ void Level::serialize(Archive& ar, const unsigned int version) {
     // some code requires these Sectors to be always initialized
     getSectors({MovementTrait::WALK});
     updateTickingFurniture();
+    if (version < 2) {
+      // Older saves only stored the summed up amounts, so the sources are found again.
+      lightEngine.reset(LightEngine(getBounds()));
+      for (Vec2 v : getBounds()) {
+        addFurnitureLight(v);
+        updateCreatureLight(v, 1);
+      }
+    } else
+      lightEngine->recompute(getLightVisibility());
   }
   if (progressMeter)
     progressMeter->addProgress();
@@ -107,7 +128,7 @@ void Level::updateTickingFurniture() {
         if (auto t = f->getTickType()) {
           if (auto chance = getChanceTick(*t))
             furniture->getBuilt(layer).getWritable(v)->tickType = FurnitureTickType(std::move(*chance->effect));
-          tickingFurniture.insert(make_pair(make_pair(v, layer), -1));
+          addTickingFurniture(v, layer, -1);
         }
         if ((f->getFire() && f->getFire()->isBurning()) || f->hasBlood())
           burningFurniture.insert(make_pair(v, layer));
@@ -134,7 +155,7 @@ Level::Level(Private, SquareArray s, FurnitureArray f, Model* m, Table<double> s
       sunlight(sun),
       bucketMap(squares->getBounds().getSize(), FieldOfView::sightRange),
       swarmMaps(getSwarmMaps(squares->getBounds().getSize())),
-      lightAmount(squares->getBounds(), 0), lightCapAmount(squares->getBounds(), 1),
+      lightEngine(squares->getBounds()),
       levelId(id) {
   updateTickingFurniture();
 }
@@ -153,7 +174,7 @@ PLevel Level::create(SquareArray s, FurnitureArray f, Model* m,
   for (VisionId vision : ENUM_ALL(VisionId))
     (*ret->fieldOfView)[vision] = FieldOfView(ret.get(), vision, factory);
   for (auto pos : ret->getAllPositions()) {
-    ret->addLightSource(pos.getCoord(), pos.getLightEmission(), 1);
+    ret->addFurnitureLight(pos.getCoord());
     for (auto layer : ENUM_ALL(FurnitureLayer))
       if (auto f = pos.getFurniture(layer)) {
         if (auto& effect = f->getLastingEffectInfo())
@@ -197,30 +218,29 @@ void Level::removeLightSource(Vec2 pos, double radius) {
   addLightSource(pos, radius, -1);
 }
 
+function<const vector<SVec2>&(Vec2)> Level::getLightVisibility() const {
+  return [this](Vec2 pos) -> const vector<SVec2>& { return getVisibleTilesNoDarkness(pos, VisionId::NORMAL); };
+}
+
 void Level::addLightSource(Vec2 pos, double radius, int numLight) {
   PROFILE;
-  if (radius > 0) {
-    for (Vec2 v : getVisibleTilesNoDarkness(pos, VisionId::NORMAL)) {
-      double dist = (v - pos).lengthD();
-      if (dist <= radius) {
-        lightAmount[v] += min(1.0, 1 - (dist) / radius) * numLight;
-        setNeedsRenderUpdate(v, true);
-      }
-    }
-  }
+  auto area = lightEngine->addSource(pos, radius, false, numLight, getLightVisibility());
+  for (Vec2 v : area)
+    setNeedsRenderUpdate(v, true);
+  perceptionCache->changed(area);
 }
 
 void Level::addDarknessSource(Vec2 pos, double radius, int numDarkness) {
-  if (radius > 0) {
-    for (Vec2 v : getVisibleTilesNoDarkness(pos, VisionId::NORMAL)) {
-      double dist = (v - pos).lengthD();
-      if (dist <= radius) {
-        lightCapAmount[v] -= min(1.0, 1 - (dist) / radius) * numDarkness;
-        setNeedsRenderUpdate(v, true);
-      }
-//      updateConnectivity(v);
-    }
-  }
+  auto area = lightEngine->addSource(pos, radius, true, numDarkness, getLightVisibility());
+  for (Vec2 v : area)
+    setNeedsRenderUpdate(v, true);
+  perceptionCache->changed(area);
+}
+
+void Level::addFurnitureLight(Vec2 pos) {
+  for (auto layer : ENUM_ALL(FurnitureLayer))
+    if (auto f = furniture->getBuilt(layer).getReadonly(pos))
+      addLightSource(pos, f->getLightEmission(), 1);
 }
 
 void Level::updateCreatureLight(Vec2 pos, int diff) {
@@ -236,18 +256,16 @@ void Level::updateCreatureLight(Vec2 pos, int diff) {
 
 void Level::updateVisibility(Vec2 changedSquare) {
   auto allVisible = getVisibleTilesNoDarkness(changedSquare, VisionId::NORMAL);
-  for (Vec2 pos : allVisible) {
-    addLightSource(pos, Position(pos, this).getLightEmission(), -1);
-    updateCreatureLight(pos, -1);
-  }
   for (VisionId vision : ENUM_ALL(VisionId))
     getFieldOfView(vision).squareChanged(changedSquare);
-  for (Vec2 pos : allVisible) {
-    addLightSource(pos, Position(pos, this).getLightEmission(), 1);
-    updateCreatureLight(pos, 1);
+  perceptionCache->changed(changedSquare);
+  for (auto& area : lightEngine->squareChanged(changedSquare, getLightVisibility())) {
+    for (Vec2 v : area)
+      setNeedsRenderUpdate(v, true);
+    perceptionCache->changed(area);
   }
-  for (Vec2 pos : allVisible)
-    getModel()->addEvent(EventInfo::VisibilityChanged{Position(pos, this)});
+  if (!allVisible.empty())
+    getModel()->addEvent(EventInfo::VisibilityChanged{this, std::move(allVisible)});
 }
 
 vector<Creature*> Level::getPlayers() const {
@@ -264,8 +282,12 @@ Game* Level::getGame() const {
   return model->getGame();
 }
 
+PerceptionCache& Level::getPerceptionCache() const {
+  return *perceptionCache;
+}
+
 double Level::getLight(Vec2 pos) const {
-  return min(1.0, max(0.0, min(covered[pos] ? 1.0 : lightCapAmount[pos], lightAmount[pos] +
+  return min(1.0, max(0.0, min(covered[pos] ? 1.0 : lightEngine->getLightCap(pos), lightEngine->getLight(pos) +
       sunlight[pos] * getGame()->getSunlightInfo().getLightAmount())));
 }
 
@@ -486,6 +508,7 @@ void Level::unplaceCreature(Creature* creature, Vec2 pos) {
     unplaceSwarmer(pos, creature);
   updateCreatureLight(pos, -1);
   modSafeSquare(pos)->removeCreature(Position(pos, this));
+  perceptionCache->changed(pos);
   model->increaseMoveCounter();
   forEachEffect(pos, creature->getTribeId(),
       [&] (LastingOrBuff effect) {removePermanentEffect(effect, creature, false);});
@@ -503,6 +526,7 @@ void Level::placeCreature(Creature* creature, Vec2 pos) {
   if (creature->isAffected(LastingEffect::SWARMER))
     placeSwarmer(pos, creature);
   modSafeSquare(pos)->putCreature(creature);
+  perceptionCache->changed(pos);
   updateCreatureLight(pos, 1);
   position.onEnter(creature);
   model->increaseMoveCounter();
@@ -572,8 +596,48 @@ void Level::addTickingSquare(Vec2 pos) {
   tickingSquares.insert(pos);
 }
 
-void Level::addTickingFurniture(Vec2 pos, FurnitureLayer layer) {
-  tickingFurniture[make_pair(pos, layer)] = 1.0;
+void Level::addTickingFurniture(Vec2 pos, FurnitureLayer layer, double chance) {
+  auto key = make_pair(pos, layer);
+  auto& info = tickingFurniture[key];
+  info.chance = chance;
+  // A non-positive chance is looked up in the furniture data on the first tick.
+  scheduleFurnitureTick(key, info, 1);
+}
+
+void Level::scheduleFurnitureTick(FurnitureKey key, TickingFurniture& info, int delay) {
+  furnitureTicks.add(furnitureTickTime + TimeInterval(delay), make_pair(key, ++info.generation));
+}
+
+void Level::tickFurniture() {
+  furnitureTickTime += 1_visible;
+  auto& furnitureFactory = getGame()->getContentFactory()->furniture;
+  for (auto& entry : furnitureTicks.popExpired(furnitureTickTime)) {
+    auto& key = entry.first;
+    auto info = getReferenceMaybe(tickingFurniture, key);
+    // Skip entries that were rescheduled in the meantime.
+    if (!info || info->generation != entry.second)
+      continue;
+    auto f = furniture->getBuilt(key.second).getWritable(key.first);
+    if (!f) {
+      tickingFurniture.erase(key);
+      continue;
+    }
+    if (info->chance <= 0) {
+      if (auto tickType = furnitureFactory.getData(f->getType()).tickType)
+        if (auto chanceTick = getChanceTick(*tickType))
+          info->chance = chanceTick->value;
+      if (info->chance <= 0)
+        info->chance = 1;
+      // This is the first roll, so it may not succeed yet.
+      int delay = Random.getGeometric(info->chance);
+      if (delay > 1) {
+        scheduleFurnitureTick(key, *info, delay - 1);
+        continue;
+      }
+    }
+    scheduleFurnitureTick(key, *info, Random.getGeometric(info->chance));
+    f->tick(Position(key.first, this), key.second);
+  }
 }
 
 void Level::addBurningFurniture(Vec2 pos, FurnitureLayer layer) {
@@ -582,21 +646,10 @@ void Level::addBurningFurniture(Vec2 pos, FurnitureLayer layer) {
 
 void Level::tick() {
   PROFILE_BLOCK("Level::tick");
+  perceptionCache->clear();
   for (Vec2 pos : tickingSquares)
     squares->getWritable(pos)->tick(Position(pos, this));
-  auto& furnitureFactory = getGame()->getContentFactory()->furniture;
-  for (auto& elem : tickingFurniture)
-    if (auto f = furniture->getBuilt(elem.first.second).getWritable(elem.first.first)) {
-      auto& chance = elem.second;
-      if (chance <= 0)
-        if (auto tickType = furnitureFactory.getData(f->getType()).tickType)
-          if (auto chanceTick = getChanceTick(*tickType))
-            chance = chanceTick->value;
-      if (chance <= 0)
-        chance = 1;
-      if (Random.chance(chance))
-        f->tick(Position(elem.first.first, this), elem.first.second);
-    }
+  tickFurniture();
   for (auto& elem : burningFurniture)
     if (auto f = furniture->getBuilt(std::get<1>(elem)).getWritable(std::get<0>(elem)))
       f->updateFire(Position(std::get<0>(elem), this), std::get<1>(elem));
@@ -676,6 +729,32 @@ Sectors& Level::getSectors(const MovementType& movement) const {
   }
 }
 
+static MovementType getOnlyMovement(const MovementType& movement) {
+  return copyOf(movement).setCanBuildBridge(false).setDestroyActions({});
+}
+
+const Table<float>& Level::getNavigationCosts(const MovementType& movement) const {
+  PROFILE;
+  if (auto res = getReferenceMaybe(navigationCosts, movement))
+    return *res;
+  else {
+    PROFILE_BLOCK("Gen navigation costs");
+    auto& movementSectors = getSectors(movement);
+    auto& onlyMovementSectors = getSectors(getOnlyMovement(movement));
+    Table<float> costs(getBounds());
+    for (Vec2 v : getBounds())
+      costs[v] = Position(v, const_cast<Level*>(this), Position::IsValid{})
+          .getNavigationCostCalc(movement, movementSectors, onlyMovementSectors);
+    return navigationCosts.insert(make_pair(movement, std::move(costs))).first->second;
+  }
+}
+
+void Level::updateNavigationCosts(Vec2 v) {
+  for (auto& elem : navigationCosts)
+    elem.second[v] = Position(v, this, Position::IsValid{}).getNavigationCostCalc(elem.first,
+        getSectors(elem.first), getSectors(getOnlyMovement(elem.first)));
+}
+
 void Level::prepareForRetirement() {
   for (auto l : ENUM_ALL(FurnitureLayer))
     furniture->getBuilt(l).clearModified();
@@ -685,6 +764,9 @@ void Level::updateSunlightMovement() {
   for (auto movement : getKeys(sectors))
     if (movement.isSunlightVulnerable())
       sectors.erase(movement);
+  for (auto movement : getKeys(navigationCosts))
+    if (movement.isSunlightVulnerable())
+      navigationCosts.erase(movement);
 }
 
 int Level::getNumGeneratedSquares() const {
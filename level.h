@@ -27,6 +27,8 @@
 #include "creature_list.h"
 #include "lasting_or_buff.h"
 #include "t_string.h"
+#include "timer_wheel.h"
+#include "perception_cache.h"
 
 class Model;
 class Square;
@@ -46,6 +48,7 @@ class FurnitureArray;
 class Vision;
 class FieldOfView;
 class ContentFactory;
+class LightEngine;
 struct PhylacteryInfo;
 
 /** A class representing a single level of the dungeon or the overworld. All events occuring on the level are performed by this class.*/
@@ -106,7 +109,7 @@ class Level : public OwnedObject<Level> {
   vector<Position> getAllLandingPositions() const;
 
   void addTickingSquare(Vec2 pos);
-  void addTickingFurniture(Vec2 pos, FurnitureLayer);
+  void addTickingFurniture(Vec2 pos, FurnitureLayer, double chance = 1);
   void addBurningFurniture(Vec2 pos, FurnitureLayer);
 
   void tick();
@@ -137,6 +140,7 @@ class Level : public OwnedObject<Level> {
 
   /** Returns the amount of light in the square, capped within (0, 1).*/
   double getLight(Vec2) const;
+  PerceptionCache& getPerceptionCache() const;
   double getLevelGenSunlight(Vec2) const;
 
   void updateSunlightMovement();
@@ -155,6 +159,13 @@ class Level : public OwnedObject<Level> {
   void setFurniture(Vec2, PFurniture);
 
   Sectors& getSectors(const MovementType&) const;
+  // Cost of entering each square, not counting creatures. 0 means the square can be walked on
+  // without destroying or building anything, and its cost depends only on whether it's occupied.
+  // A negative cost means the square has to be destroyed or bridged. Its cost depends on furniture health,
+  // fire and territory, which change without a connectivity update, so it's left to
+  // Position::getDestroyOrBridgeCost().
+  const Table<float>& getNavigationCosts(const MovementType&) const;
+  void updateNavigationCosts(Vec2);
   struct EffectSet {
     vector<LastingOrBuff> SERIAL(friendly);
     vector<LastingOrBuff> SERIAL(hostile);
@@ -185,10 +196,23 @@ class Level : public OwnedObject<Level> {
   HeapAllocated<FurnitureArray> SERIAL(furniture);
   Table<bool> SERIAL(memoryUpdates);
   Table<bool> renderUpdates = Table<bool>(getMaxBounds(), true);
+  mutable HeapAllocated<PerceptionCache> perceptionCache = HeapAllocated<PerceptionCache>(getMaxBounds());
   Table<bool> SERIAL(unavailable);
   LandingSquares SERIAL(landingSquares);
   set<Vec2> SERIAL(tickingSquares);
-  HashMap<pair<Vec2, FurnitureLayer>, double> tickingFurniture;
+  // Ticking furniture sleeps until the turn its tick chance next succeeds, so each turn only
+  // touches the furniture that actually ticks. Rebuilt on load, which doesn't change the odds.
+  using FurnitureKey = pair<Vec2, FurnitureLayer>;
+  struct TickingFurniture {
+    double chance = 1;
+    // Bumped on every schedule, so that only the latest wheel entry of the furniture ticks.
+    int generation = 0;
+  };
+  HashMap<FurnitureKey, TickingFurniture> tickingFurniture;
+  TimerWheel<pair<FurnitureKey, int>, LocalTime> furnitureTicks;
+  LocalTime furnitureTickTime;
+  void scheduleFurnitureTick(FurnitureKey, TickingFurniture&, int delay);
+  void tickFurniture();
   HashSet<pair<Vec2, FurnitureLayer>> burningFurniture;
   void placeCreature(Creature*, Vec2 pos);
   void unplaceCreature(Creature*, Vec2 pos);
@@ -200,10 +224,10 @@ class Level : public OwnedObject<Level> {
   Table<bool> SERIAL(covered);
   HeapAllocated<CreatureBucketMap> SERIAL(bucketMap);
   vector<pair<int, CreatureBucketMap>> SERIAL(swarmMaps);
-  Table<double> SERIAL(lightAmount);
-  Table<double> SERIAL(lightCapAmount);
+  HeapAllocated<LightEngine> SERIAL(lightEngine);
   EnumMap<TribeId::KeyType, unique_ptr<EffectsTable>> SERIAL(furnitureEffects);
   mutable HashMap<MovementType, Sectors> sectors;
+  mutable HashMap<MovementType, Table<float>> navigationCosts;
   Sectors& getSectorsDontCreate(const MovementType&) const;
 
   friend class LevelBuilder;
@@ -218,12 +242,14 @@ class Level : public OwnedObject<Level> {
   private:
   void addLightSource(Vec2 pos, double radius, int numLight);
   void addDarknessSource(Vec2 pos, double radius, int numLight);
+  function<const vector<SVec2>&(Vec2)> getLightVisibility() const;
   FieldOfView& getFieldOfView(VisionId vision) const;
   const vector<SVec2>& getVisibleTilesNoDarkness(Vec2 pos, VisionId vision) const;
   bool isWithinVision(Vec2 from, Vec2 to, const Vision&) const;
   LevelId SERIAL(levelId) = 0;
   bool SERIAL(noDiagonalPassing) = false;
   void updateCreatureLight(Vec2, int diff);
+  void addFurnitureLight(Vec2);
   template<typename Fun>
   void forEachEffect(Vec2, TribeId, Fun);
   void placeSwarmer(Vec2, Creature*);
@@ -231,4 +257,4 @@ class Level : public OwnedObject<Level> {
   void updateTickingFurniture();
 };
 
-CEREAL_CLASS_VERSION(Level, 1)
\ No newline at end of file
+CEREAL_CLASS_VERSION(Level, 2)
\ No newline at end of file
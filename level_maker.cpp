@@ -55,6 +55,107 @@
 #include "keeper_base_info.h"
 #include "clock.h"
 
+static int parallelGenerationThreads = 1;
+
+namespace {
+
+// Threads that prepare makers, kept alive between calls to RandomLocations. Every worker runs each job once,
+// alongside the calling thread.
+class PrepareThreads {
+  public:
+  void run(int numThreads, function<void()> job) {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (threads.size() < numThreads - 1)
+      threads.push_back(makeThread([this, generation = jobGeneration] { workerLoop(generation); }));
+    currentJob = &job;
+    numRunning = threads.size();
+    ++jobGeneration;
+    wake.notify_all();
+    lock.unlock();
+    job();
+    lock.lock();
+    done.wait(lock, [this] { return numRunning == 0; });
+    currentJob = nullptr;
+  }
+
+  ~PrepareThreads() {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      quit = true;
+    }
+    wake.notify_all();
+    for (auto& t : threads)
+      t.join();
+  }
+
+  private:
+  void workerLoop(int seenGeneration) {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      wake.wait(lock, [&] { return quit || jobGeneration != seenGeneration; });
+      if (quit)
+        return;
+      seenGeneration = jobGeneration;
+      auto job = currentJob;
+      lock.unlock();
+      (*job)();
+      lock.lock();
+      if (--numRunning == 0)
+        done.notify_all();
+    }
+  }
+
+  vector<thread> threads;
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable done;
+  function<void()>* currentJob = nullptr;
+  int jobGeneration = 0;
+  int numRunning = 0;
+  bool quit = false;
+};
+
+}
+
+void LevelMaker::setParallelGeneration(int numThreads) {
+  USER_CHECK(numThreads >= 1) << "Bad number of world generation threads: " << numThreads;
+  parallelGenerationThreads = numThreads;
+}
+
+// The seeds are drawn from the builder's RandomGen before any thread starts, so each maker is prepared the same way
+// no matter which thread picks it up, or whether there is only one thread. Errors are rethrown in the order of
+// the makers.
+static void prepareMakers(RandomGen& random, const vector<pair<LevelMaker*, Rectangle>>& makers) {
+  PROFILE;
+  if (makers.empty())
+    return;
+  vector<unique_ptr<RandomGen>> randoms;
+  for (int i : All(makers)) {
+    randoms.push_back(make_unique<RandomGen>());
+    randoms.back()->init(random.get(std::numeric_limits<int>::max()));
+  }
+  vector<std::exception_ptr> errors(makers.size());
+  std::atomic<int> next(0);
+  auto work = [&] {
+    for (int i = next++; i < makers.size(); i = next++)
+      try {
+        makers[i].first->prepare(makers[i].second, *randoms[i]);
+      } catch (...) {
+        errors[i] = std::current_exception();
+      }
+  };
+  int numThreads = min(parallelGenerationThreads, makers.size());
+  if (numThreads == 1)
+    work();
+  else {
+    static PrepareThreads threads;
+    threads.run(numThreads, work);
+  }
+  for (auto& error : errors)
+    if (error)
+      std::rethrow_exception(error);
+}
+
 namespace {
 
 void failGen() {
@@ -1067,6 +1168,11 @@ class MakerQueue : public LevelMaker {
       maker->make(builder, area);
   }
 
+  virtual void prepare(Rectangle area, RandomGen& random) override {
+    for (auto& maker : makers)
+      maker->prepare(area, random);
+  }
+
   private:
   vector<PLevelMaker> makers;
 };
@@ -1297,6 +1403,11 @@ class RandomLocations : public LevelMaker {
         return false;
     }
     CHECK(insideMakers.size() == occupied.size());
+    vector<pair<LevelMaker*, Rectangle>> toPrepare;
+    for (int i : All(insideMakers))
+      if (makerBounds[i])
+        toPrepare.push_back(make_pair(insideMakers[i].get(), *makerBounds[i]));
+    prepareMakers(builder->getRandom(), toPrepare);
     for (int i : All(insideMakers))
       if (makerBounds[i]) {
         PROFILE_BLOCK("insider makers");
@@ -1347,14 +1458,19 @@ class Margin : public LevelMaker {
 
   virtual void make(LevelBuilder* builder, Rectangle area) override {
     CHECK(area.width() > left + right && area.height() > top + bottom);
-    inside->make(builder, Rectangle(
-          area.left() + left,
-          area.top() + top,
-          area.right() - right,
-          area.bottom() - bottom));
+    inside->make(builder, getInside(area));
+  }
+
+  virtual void prepare(Rectangle area, RandomGen& random) override {
+    if (area.width() > left + right && area.height() > top + bottom)
+      inside->prepare(getInside(area), random);
   }
 
   private:
+  Rectangle getInside(Rectangle area) const {
+    return Rectangle(area.left() + left, area.top() + top, area.right() - right, area.bottom() - bottom);
+  }
+
   int left, top, right, bottom;
   PLevelMaker inside;
 };
@@ -2753,24 +2869,30 @@ namespace {
           return builder->getContentFactory()->furniture.getFurnitureList(elem); });
       auto outside = outsideFurniture.map([&](auto elem) {
           return builder->getContentFactory()->furniture.getFurnitureList(elem); });
-      auto tryGenerate = [&] (int count) -> optional<Table<vector<Token>>> {
-        for (int it : Range(count)) {
-          LayoutCanvas::Map map{Table<vector<Token>>(area)};
-          LayoutCanvas canvas{map.elems.getBounds(), &map};
-          if (generator.make(canvas, builder->getRandom()))
-            return map.elems;
-        }
-        return none;
-      };
       auto stockpileData = stockpile.transform([&](const auto& stockpile) {
         return StockpileData{builder->getContentFactory()->itemFactory.get(stockpile.items), stockpile.count, stockpile.furniture};
       });
-      if (auto map1 = tryGenerate(10)) {
+      optional<Table<LayoutTile>> map1;
+      if (prepared && prepared->area == area)
+        map1 = std::move(prepared->map);
+      else
+        map1 = generate(area, builder->getRandom());
+      prepared = none;
+      if (map1) {
         auto& map = *map1;
         vector<vector<Vec2>> shopPositions;
+        vector<optional<const LayoutAction*>> actions(LayoutToken::getNumTokens());
+        auto getAction = [&] (LayoutToken token) {
+          auto& action = actions[token.getId()];
+          if (!action) {
+            auto elem = getReferenceMaybe(mapping.actions, token.data());
+            action = elem ? &*elem : nullptr;
+          }
+          return *action;
+        };
         for (auto pos : area)
-          for (auto& token : map[pos])
-            if (auto a = getReferenceMaybe(mapping.actions, token))
+          for (auto token : map[pos])
+            if (auto a = getAction(token))
               visit(builder, inside, outside, pos, stockpileData, *a, shopPositions);
         for (int i : All(shopPositions))
           if (i < shopInfo.size())
@@ -2783,7 +2905,26 @@ namespace {
         failGen();
     }
 
+    virtual void prepare(Rectangle area, RandomGen& random) override {
+      prepared = Prepared{area, generate(area, random)};
+    }
+
     private:
+    optional<Table<LayoutTile>> generate(Rectangle area, RandomGen& random) const {
+      for (int it : Range(10)) {
+        LayoutCanvas::Map map{Table<LayoutTile>(area)};
+        LayoutCanvas canvas{map.elems.getBounds(), &map};
+        if (generator.make(canvas, random))
+          return std::move(map.elems);
+      }
+      return none;
+    }
+
+    struct Prepared {
+      Rectangle area;
+      optional<Table<LayoutTile>> map;
+    };
+    optional<Prepared> prepared;
     const RandomLayoutId id;
     const LayoutMapping& mapping;
     const LayoutGenerator& generator;
@@ -41,8 +41,16 @@ struct KeeperBaseInfo;
 class LevelMaker {
   public:
   virtual void make(LevelBuilder* builder, Rectangle area) = 0;
+  // Does the work of make() that doesn't need the builder ahead of time, possibly on another thread. It's only
+  // called for makers placed by RandomLocations, and make() is later called with the same area.
+  virtual void prepare(Rectangle area, RandomGen&) {}
   virtual ~LevelMaker() {}
 
+  // The makers that RandomLocations places in the level are prepared on up to numThreads threads (1 by default)
+  // before they are made one by one. Each of them gets its own RandomGen forked from the builder's in a fixed
+  // order, also with one thread, so the generated level depends on the seed but not on the number of threads.
+  static void setParallelGeneration(int numThreads);
+
   static PLevelMaker topLevel(RandomGen&, vector<SettlementInfo> village, int width, int difficulty,
       optional<TribeId> keeperTribe, optional<KeeperBaseInfo>, BiomeInfo, ResourceCounts, const ContentFactory&);
   static PLevelMaker mineTownLevel(RandomGen&, SettlementInfo, Vec2 size, int difficulty);
@@ -0,0 +1,147 @@
+#include "stdafx.h"
+#include "light_engine.h"
+
+static constexpr int bucketSize = 8;
+
+// Amounts are rounded to multiples of 1/4096, so sums of them are exact in a float and removing a source
+// brings the grid back to exactly where it was. Some code compares the light cap with 1.
+static float quantize(double amount) {
+  return std::round(amount * 4096) / 4096;
+}
+
+template <class Archive>
+void LightEngine::serialize(Archive& ar, const unsigned int) {
+  ar(bounds, sources);
+}
+
+SERIALIZABLE(LightEngine)
+
+SERIALIZATION_CONSTRUCTOR_IMPL(LightEngine)
+
+LightEngine::LightEngine(Rectangle bounds) : bounds(bounds), light(bounds.area(), 0), darkness(bounds.area(), 0) {
+  rebuildBuckets();
+}
+
+bool LightEngine::Patch::isVisible(Vec2 v) const {
+  return v.inRectangle(area) && visible[(v.y - area.top()) * area.width() + v.x - area.left()];
+}
+
+LightEngine::Patch LightEngine::computePatch(Vec2 pos, double radius, const VisibleTiles& visibleTiles) const {
+  Patch ret;
+  ret.area = Rectangle::centered(pos, (int) ceil(radius)).intersection(bounds);
+  ret.amounts = vector<float>(ret.area.area(), 0);
+  ret.visible = vector<std::uint8_t>(ret.area.area(), 0);
+  for (Vec2 v : visibleTiles(pos)) {
+    double dist = (v - pos).lengthD();
+    if (dist <= radius && v.inRectangle(ret.area)) {
+      int index = (v.y - ret.area.top()) * ret.area.width() + v.x - ret.area.left();
+      ret.amounts[index] = quantize(min(1.0, 1 - dist / radius));
+      ret.visible[index] = 1;
+    }
+  }
+  return ret;
+}
+
+void LightEngine::accumulate(const Patch& patch, bool isDarkness, int count) {
+  auto& grid = isDarkness ? darkness : light;
+  const float mult = count;
+  const int width = patch.area.width();
+  for (int y : patch.area.getYRange()) {
+    // Plain loops over contiguous rows, so that the compiler can vectorize them.
+    float* dst = grid.data() + (y - bounds.top()) * bounds.width() + patch.area.left() - bounds.left();
+    const float* src = patch.amounts.data() + (y - patch.area.top()) * width;
+    for (int x = 0; x < width; ++x)
+      dst[x] += mult * src[x];
+  }
+}
+
+Rectangle LightEngine::getBucketArea(const Rectangle& area) const {
+  auto topLeft = (area.topLeft() - bounds.topLeft()) / bucketSize;
+  auto bottomRight = (area.bottomRight() - bounds.topLeft() - Vec2(1, 1)) / bucketSize + Vec2(1, 1);
+  return Rectangle(topLeft, bottomRight);
+}
+
+void LightEngine::addToBuckets(Vec2 pos, const Rectangle& area) {
+  for (Vec2 v : getBucketArea(area))
+    if (!buckets[v].contains(pos))
+      buckets[v].push_back(pos);
+}
+
+void LightEngine::rebuildBuckets() {
+  buckets = Table<vector<Vec2>>(getBucketArea(bounds));
+  for (auto& elem : sources)
+    for (auto& source : elem.second)
+      addToBuckets(elem.first, source.patch.area);
+}
+
+Rectangle LightEngine::addSource(Vec2 pos, double radius, bool isDarkness, int count, const VisibleTiles& visibleTiles) {
+  PROFILE;
+  if (radius <= 0 || count == 0 || !pos.inRectangle(bounds))
+    return Rectangle();
+  auto& posSources = sources[pos];
+  auto source = [&]() -> Source* {
+    for (auto& source : posSources)
+      if (source.radius == radius && source.darkness == isDarkness)
+        return &source;
+    return nullptr;
+  }();
+  if (count > 0) {
+    if (!source) {
+      posSources.push_back(Source{radius, isDarkness, 0, computePatch(pos, radius, visibleTiles)});
+      source = &posSources.back();
+      addToBuckets(pos, source->patch.area);
+    }
+    source->count += count;
+    accumulate(source->patch, isDarkness, count);
+    return source->patch.area;
+  }
+  Rectangle ret;
+  if (source) {
+    int removed = min(source->count, -count);
+    ret = source->patch.area;
+    accumulate(source->patch, isDarkness, -removed);
+    source->count -= removed;
+    if (source->count == 0)
+      posSources.removeIndex(source - posSources.data());
+  }
+  if (posSources.empty())
+    sources.erase(pos);
+  return ret;
+}
+
+void LightEngine::recompute(const VisibleTiles& visibleTiles) {
+  light = vector<float>(bounds.area(), 0);
+  darkness = vector<float>(bounds.area(), 0);
+  for (auto& elem : sources)
+    for (auto& source : elem.second) {
+      source.patch = computePatch(elem.first, source.radius, visibleTiles);
+      accumulate(source.patch, source.darkness, source.count);
+    }
+  rebuildBuckets();
+}
+
+vector<Rectangle> LightEngine::squareChanged(Vec2 pos, const VisibleTiles& visibleTiles) {
+  PROFILE;
+  vector<Rectangle> ret;
+  if (!pos.inRectangle(bounds))
+    return ret;
+  // Buckets may still list positions whose sources are all gone.
+  for (auto sourcePos : buckets[(pos - bounds.topLeft()) / bucketSize])
+    if (auto posSources = getReferenceMaybe(sources, sourcePos))
+      for (auto& source : *posSources)
+        if (source.patch.isVisible(pos)) {
+          accumulate(source.patch, source.darkness, -source.count);
+          source.patch = computePatch(sourcePos, source.radius, visibleTiles);
+          accumulate(source.patch, source.darkness, source.count);
+          ret.push_back(source.patch.area);
+        }
+  return ret;
+}
+
+double LightEngine::getLight(Vec2 pos) const {
+  return light[(pos.y - bounds.top()) * bounds.width() + pos.x - bounds.left()];
+}
+
+double LightEngine::getLightCap(Vec2 pos) const {
+  return 1 - darkness[(pos.y - bounds.top()) * bounds.width() + pos.x - bounds.left()];
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "util.h"
+
+// Sums up the light and darkness cast on a level. Every source keeps the patch of amounts that it added,
+// so it can be removed exactly, and when a square changes only the sources that see it are recomputed.
+// Only the sources are saved, so recompute() has to be called after loading.
+class LightEngine {
+  public:
+  LightEngine(Rectangle bounds);
+
+  using VisibleTiles = function<const vector<SVec2>&(Vec2)>;
+  // Adds count copies of a light or darkness source, or removes them if count is negative.
+  // Removing a source that wasn't added does nothing.
+  // Returns the area in which the amounts might have changed.
+  Rectangle addSource(Vec2 pos, double radius, bool darkness, int count, const VisibleTiles&);
+  // Recomputes the patches of all sources and the amounts.
+  void recompute(const VisibleTiles&);
+  // Recomputes the sources that see the square. Has to be called after the field of view has been updated.
+  // Returns the areas in which the amounts might have changed.
+  vector<Rectangle> squareChanged(Vec2, const VisibleTiles&);
+
+  double getLight(Vec2) const;
+  double getLightCap(Vec2) const;
+
+  SERIALIZATION_DECL(LightEngine)
+
+  private:
+  struct Patch {
+    Rectangle area;
+    vector<float> amounts;
+    vector<std::uint8_t> visible;
+    bool isVisible(Vec2) const;
+  };
+  struct Source {
+    double SERIAL(radius);
+    bool SERIAL(darkness);
+    int SERIAL(count);
+    Patch patch;
+    SERIALIZE_ALL(radius, darkness, count)
+  };
+  Patch computePatch(Vec2 pos, double radius, const VisibleTiles&) const;
+  void accumulate(const Patch&, bool darkness, int count);
+  void addToBuckets(Vec2 pos, const Rectangle& area);
+  Rectangle getBucketArea(const Rectangle&) const;
+  void rebuildBuckets();
+  Rectangle SERIAL(bounds);
+  vector<float> light;
+  vector<float> darkness;
+  HashMap<Vec2, vector<Source>> SERIAL(sources);
+  // Positions of the sources whose patch overlaps each bucket of the level.
+  Table<vector<Vec2>> buckets = Table<vector<Vec2>>(0, 0);
+};
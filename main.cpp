@@ -54,9 +54,11 @@
 #include "fx_manager.h"
 #include "fx_renderer.h"
 #include "fx_view_manager.h"
+#include "fx_benchmark.h"
 #include "layout_renderer.h"
 #include "unlocks.h"
 #include "steam_input.h"
+#include "level_maker.h"
 #include "steam_achievements.h"
 
 #include "stack_printer.h"
@@ -129,6 +131,10 @@ static po::parser getCommandLineFlags() {
   flags["run_tests"].description("Run all unit tests and exit");
   flags["worldgen_test"].type(po::i32).description("Test how often world generation fails");
   flags["worldgen_maps"].type(po::string).description("List of maps or enemy types in world generation test. Skip to test all.");
+  flags["worldgen_seed"].type(po::i32).description("Random seed for the world generation test");
+  flags["worldgen_threads"].type(po::i32).description("Prepare independent parts of levels on this many threads");
+  flags["worldgen_check_threads"].type(po::i32).description("Run the world generation test with one thread and "
+      "with this many threads, and fail if the generated levels differ");
   flags["battle_level"].type(po::string).description("Path to battle test level");
   flags["battle_info"].type(po::string).description("Path to battle info file");
   flags["battle_enemy"].type(po::string).description("Battle enemy id");
@@ -138,9 +144,14 @@ static po::parser getCommandLineFlags() {
   flags["battle_rounds"].type(po::i32).description("Number of battle rounds");
   flags["layout_size"].type(po::string).description("Size of the generated map layout");
   flags["layout_name"].type(po::string).description("Name of layout to generate");
+  flags["fx_benchmark"].type(po::i32).description("Simulate all particle effects for a given number of frames without a window and print timings");
+  flags["fx_benchmark_instances"].type(po::i32).description("Number of instances of every particle effect in the fx benchmark");
+  flags["run_benchmarks"].description("Run the timing benchmarks of the unit test suite and exit");
   flags["stderr"].description("Log to stderr");
   flags["console"].description("Attach windows console");
   flags["nolog"].description("No logging");
+  flags["profile"].description("Run the profiler from the start and allow toggling it with F7. The results are written to profile.json and profile.txt");
+  flags["log_level"].type(po::string).description("Minimum level of logged messages: verbose, normal or none");
   flags["no_crash_reports"].description("Don't intercept game crashes and send crash reports to the developer");
   flags["free_mode"].description("Run in free ascii mode");
   flags["gen_z_levels"].type(po::string).description("Generate and print z-level types for a given keeper");
@@ -176,8 +187,10 @@ int main(int argc, char* argv[]) {
   po::parser flags = getCommandLineFlags();
   if (!flags.parseArgs(argc, argv))
     return -1;
-  if (!flags["no_crash_reports"].was_set())
+  if (!flags["no_crash_reports"].was_set()) {
+    setCrashHook([] { InfoLog.flushOnCrash(); });
     initializeMiniDump();
+  }
   std::set_terminate(onException);
   setInitializedStatics();
   if (flags["console"].was_set())
@@ -259,6 +272,11 @@ static int keeperMain(po::parser& commandLineFlags) {
     std::cout << commandLineFlags << endl;
     return 0;
   }
+  if (commandLineFlags["profile"].was_set()) {
+    Profiler::setHotkeyEnabled(true);
+    Profiler::start();
+  }
+  OnExit stopProfiler([] { Profiler::stop(); });
   FatalLog.addOutput(DebugOutput::crash());
   FatalLog.addOutput(DebugOutput::toStream(std::cerr));
   UserErrorLog.addOutput(DebugOutput::exitProgram());
@@ -266,19 +284,46 @@ static int keeperMain(po::parser& commandLineFlags) {
   UserInfoLog.addOutput(DebugOutput::toStream(std::cerr));
   auto trigger = AttackTrigger(StolenItems{});
   CHECK(!!trigger.getReferenceMaybe<StolenItems>());
+  if (commandLineFlags["log_level"].was_set()) {
+    auto level = commandLineFlags["log_level"].get().string;
+    if (level == "verbose")
+      InfoLog.setMinLevel(LogLevel::VERBOSE);
+    else if (level == "normal")
+      InfoLog.setMinLevel(LogLevel::NORMAL);
+    else if (level == "none")
+      InfoLog.setMinLevel(LogLevel::NONE);
+    else
+      USER_FATAL << "Unknown log level: " << level;
+  }
 #ifndef RELEASE
   ogzstream compressedLog("log.gz");
-  /*if (!commandLineFlags["nolog"].was_set())
-    InfoLog.addOutput(DebugOutput::toStream(compressedLog));*/
+  if (!commandLineFlags["nolog"].was_set())
+    InfoLog.addOutput(DebugOutput::toStream(compressedLog));
+  // The log is written on another thread, so the outputs must get everything before they go out of scope.
+  OnExit flushLog([] { InfoLog.flush(); });
 #endif
   FatalLog.addOutput(DebugOutput::toString(
       [](const string& s) { ofstream("stacktrace.out") << s << "\n" << std::flush; } ));
-  if (commandLineFlags["stderr"].was_set() || commandLineFlags["run_tests"].was_set())
+  if (commandLineFlags["stderr"].was_set() || commandLineFlags["run_tests"].was_set() ||
+      commandLineFlags["run_benchmarks"].was_set())
     InfoLog.addOutput(DebugOutput::toStream(std::cerr));
   if (commandLineFlags["run_tests"].was_set()) {
     testAll();
     return 0;
   }
+  if (commandLineFlags["run_benchmarks"].was_set()) {
+    runBenchmarks();
+    return 0;
+  }
+  if (commandLineFlags["fx_benchmark"].was_set()) {
+    fx::BenchmarkConfig config;
+    config.numFrames = commandLineFlags["fx_benchmark"].get().i32;
+    if (commandLineFlags["fx_benchmark_instances"].was_set())
+      config.instancesPerEffect = commandLineFlags["fx_benchmark_instances"].get().i32;
+    USER_CHECK(config.numFrames > 0 && config.instancesPerEffect > 0) << "Bad fx benchmark parameters";
+    fx::runBenchmark(config, std::cout);
+    return 0;
+  }
   if (commandLineFlags["new_game"].was_set())
     USER_CHECK(!commandLineFlags["new_game"].get().string.empty()) << "Please enter keeper name";
   DirectoryPath dataPath([&]() -> string {
@@ -352,6 +397,8 @@ static int keeperMain(po::parser& commandLineFlags) {
   if (options.getBoolValue(OptionId::DPI_AWARE))
     dpiAwareness();
   Random.init(int(time(nullptr)));
+  if (commandLineFlags["worldgen_threads"].was_set())
+    LevelMaker::setParallelGeneration(commandLineFlags["worldgen_threads"].get().i32);
   auto installId = getInstallId(userPath.file("installId.txt"), Random);
   if (steamInput->isRunningOnDeck())
     installId += "_deck";
@@ -385,12 +432,29 @@ static int keeperMain(po::parser& commandLineFlags) {
   if (commandLineFlags["worldgen_test"].was_set()) {
     ofstream output("worldgen_out.txt");
     UserInfoLog.addOutput(DebugOutput::toStream(output));
+    if (commandLineFlags["worldgen_seed"].was_set())
+      Random.init(commandLineFlags["worldgen_seed"].get().i32);
     MainLoop loop(nullptr, &highscores, &fileSharing, paidDataPath, freeDataPath, userPath, modsDir, &options, nullptr,
         &sokobanInput, nullptr, &allUnlocked, nullptr, nullptr, 0, "");
     vector<string> types;
     if (commandLineFlags["worldgen_maps"].was_set())
       types = split(commandLineFlags["worldgen_maps"].get().string, {','});
-    loop.modelGenTest(commandLineFlags["worldgen_test"].get().i32, types, Random, &options);
+    int numTries = commandLineFlags["worldgen_test"].get().i32;
+    if (commandLineFlags["worldgen_check_threads"].was_set()) {
+      int seed = commandLineFlags["worldgen_seed"].was_set() ? commandLineFlags["worldgen_seed"].get().i32 : 0;
+      auto getChecksums = [&] (int numThreads) {
+        LevelMaker::setParallelGeneration(numThreads);
+        Random.init(seed);
+        return loop.modelGenTest(numTries, types, Random, &options);
+      };
+      auto reference = getChecksums(1);
+      if (getChecksums(commandLineFlags["worldgen_check_threads"].get().i32) != reference) {
+        USER_INFO << "Parallel world generation differs from the single-threaded reference";
+        return 1;
+      }
+      return 0;
+    }
+    loop.modelGenTest(numTries, types, Random, &options);
     return 0;
   }
   auto battleTest = [&] (View* view, TileSet* tileSet) {
@@ -510,6 +574,7 @@ static int keeperMain(po::parser& commandLineFlags) {
           appConfig.is_true("debug_options")}));
 #ifndef RELEASE
   InfoLog.addOutput(DebugOutput::toString([&view](const string& s) { view->logMessage(s);}));
+  OnExit flushViewLog([] { InfoLog.flush(); });
 #endif
   view->initialize(std::move(fxRenderer), std::move(fxViewManager));
   if (commandLineFlags["battle_level"].was_set() && commandLineFlags["battle_view"].was_set()) {
@@ -1077,7 +1077,7 @@ void MainLoop::doWithSplash(const TString& text, function<void()> fun, function<
   }
 }
 
-void MainLoop::modelGenTest(int numTries, const vector<string>& types, RandomGen& random, Options* options) {
+vector<size_t> MainLoop::modelGenTest(int numTries, const vector<string>& types, RandomGen& random, Options* options) {
   ProgressMeter meter(1);
   auto contentFactory = createContentFactory(false);
   vector<BiomeId> biomes;
@@ -1085,7 +1085,7 @@ void MainLoop::modelGenTest(int numTries, const vector<string>& types, RandomGen
     biomes.push_back(elem.first);
   EnemyFactory enemyFactory(Random, contentFactory.getCreatures().getNameGenerator(), contentFactory.enemies,
       contentFactory.buildingInfo, {});
-  ModelBuilder(&meter, random, options, sokobanInput, &contentFactory, std::move(enemyFactory))
+  return ModelBuilder(&meter, random, options, sokobanInput, &contentFactory, std::move(enemyFactory))
       .measureSiteGen(numTries, types, std::move(biomes));
 }
 
@@ -44,7 +44,8 @@ class MainLoop {
       SteamAchievements*, Translations*, int saveVersion, string modVersion);
 
   void start(bool tilesPresent);
-  void modelGenTest(int numTries, const vector<std::string>& types, RandomGen&, Options*);
+  // Returns a checksum of the generated levels for every tested map type.
+  vector<size_t> modelGenTest(int numTries, const vector<std::string>& types, RandomGen&, Options*);
   void battleTest(int numTries, const FilePath& levelPath, const FilePath& battleInfoPath, string enemyId);
   int battleTest(int numTries, const FilePath& levelPath, vector<CreatureList> ally, vector<CreatureList> enemies);
   void endlessTest(int numTries, const FilePath& levelPath, const FilePath& battleInfoPath, optional<int> numEnemy);
@@ -6,3 +6,5 @@ class MapLayoutId : public ContentId<MapLayoutId> {
   public:
   using ContentId::ContentId;
 };
+
+CEREAL_CLASS_VERSION(MapLayoutId, 1)
@@ -20,27 +20,129 @@
 #include "view_object.h"
 #include "view_index.h"
 
-SERIALIZE_DEF(MapMemory, table)
+template <class Archive>
+void MapMemory::serialize(Archive& ar, const unsigned int version) {
+  if (Archive::is_loading::value && version == 0) {
+    // Older saves stored a full ViewIndex for every remembered position.
+    HeapAllocated<PositionMap<ViewIndex>> table;
+    ar(table);
+    for (auto& level : table->getTables()) {
+      auto& tileIds = levels.insert(make_pair(level.first, Table<int>(level.second.getBounds(), -1))).first->second;
+      for (auto v : level.second.getBounds())
+        if (auto& index = level.second[v]) {
+          Tile tile;
+          tile.shell = shells.add(index->withoutObjects());
+          for (auto layer : ENUM_ALL(ViewLayer))
+            tile.objects[int(layer)] = index->hasObject(layer) ? objects.add(index->getObject(layer)) : -1;
+          setTile(tileIds[v], addTile(std::move(tile)));
+        }
+    }
+  } else
+    ar(shells, objects, tiles, levels);
+}
+
+SERIALIZABLE(MapMemory)
+
+size_t MapMemory::Tile::getHash() const {
+  return combineHash(shell, positionIds, combineHashIter(objects.begin(), objects.end()));
+}
 
 MapMemory::MapMemory() {}
 
-optional<ViewIndex&> MapMemory::getViewIndex(Position pos) {
-  return table->getReferenceMaybe(pos);
+optional<int&> MapMemory::getTileId(Position pos) {
+  if (!pos.isValid())
+    return none;
+  auto levelId = pos.getLevel()->getUniqueId();
+  auto it = levels.find(levelId);
+  if (it == levels.end())
+    it = levels.insert(make_pair(levelId, Table<int>(pos.getLevel()->getBounds(), -1))).first;
+  if (!pos.getCoord().inRectangle(it->second.getBounds()))
+    return none;
+  return it->second[pos.getCoord()];
+}
+
+optional<const int&> MapMemory::getTileId(Position pos) const {
+  if (!pos.isValid())
+    return none;
+  auto it = levels.find(pos.getLevel()->getUniqueId());
+  if (it == levels.end() || !pos.getCoord().inRectangle(it->second.getBounds()))
+    return none;
+  return it->second[pos.getCoord()];
+}
+
+int MapMemory::addTile(Tile tile) {
+  int id = tiles.add(tile);
+  // If an equal tile was already stored then it holds its own references to the shell and objects.
+  if (tiles.getRefCount(id) > 1) {
+    shells.release(tile.shell);
+    for (int object : tile.objects)
+      if (object >= 0)
+        objects.release(object);
+  }
+  return id;
+}
+
+void MapMemory::releaseTile(int id) {
+  auto tile = tiles.get(id);
+  if (tiles.release(id)) {
+    shells.release(tile.shell);
+    for (int object : tile.objects)
+      if (object >= 0)
+        objects.release(object);
+  }
+}
+
+void MapMemory::setTile(int& tileId, int newId) {
+  if (tileId >= 0)
+    releaseTile(tileId);
+  tileId = newId;
+}
+
+optional<ViewIndex> MapMemory::getViewIndex(Position pos) const {
+  auto tileId = getTileId(pos);
+  if (!tileId || *tileId < 0)
+    return none;
+  auto& tile = tiles.get(*tileId);
+  auto ret = shells.get(tile.shell);
+  for (auto layer : ENUM_ALL(ViewLayer))
+    if (tile.objects[int(layer)] >= 0) {
+      auto object = objects.get(tile.objects[int(layer)]);
+      if (tile.positionIds & (1 << int(layer)))
+        object.setGenericId(pos.getGenericId());
+      ret.insert(std::move(object));
+    }
+  return ret;
 }
 
-optional<const ViewIndex&> MapMemory::getViewIndex(Position pos) const {
-  return table->getReferenceMaybe(pos);
+bool MapMemory::contains(Position pos) const {
+  auto tileId = getTileId(pos);
+  return tileId && *tileId >= 0;
 }
 
-void MapMemory::update(Position pos, const ViewIndex& index1) {
-  auto& index = table->getOrInit(pos);
-  index = index1;
-  index.setHighlight(HighlightType::MEMORY);
-  if (index.hasObject(ViewLayer::CREATURE) &&
-      !index.getObject(ViewLayer::CREATURE).hasModifier(ViewObjectModifier::REMEMBER))
-    index.removeObject(ViewLayer::CREATURE);
-  if (index.hasObject(ViewLayer::STEED))
-    index.removeObject(ViewLayer::STEED);
+void MapMemory::update(Position pos, const ViewIndex& index) {
+  auto tileId = getTileId(pos);
+  if (!tileId)
+    return;
+  Tile tile;
+  auto shell = index.withoutObjects();
+  shell.setHighlight(HighlightType::MEMORY);
+  tile.shell = shells.add(shell);
+  for (auto layer : ENUM_ALL(ViewLayer)) {
+    tile.objects[int(layer)] = -1;
+    if (!index.hasObject(layer) || layer == ViewLayer::STEED)
+      continue;
+    auto object = index.getObject(layer);
+    if (layer == ViewLayer::CREATURE && !object.hasModifier(ViewObjectModifier::REMEMBER))
+      continue;
+    // Remembered objects don't move, and furniture ids derived from the position would prevent sharing.
+    object.clearMovementInfo();
+    if (object.getGenericId() == pos.getGenericId()) {
+      object.resetGenericId();
+      tile.positionIds |= (1 << int(layer));
+    }
+    tile.objects[int(layer)] = objects.add(object);
+  }
+  setTile(*tileId, addTile(std::move(tile)));
   updateUpdated(pos);
 }
 
@@ -50,7 +152,8 @@ void MapMemory::updateUpdated(Position pos) {
 }
 
 void MapMemory::clearSquare(Position pos) {
-  getViewIndex(pos) = none;
+  if (auto tileId = getTileId(pos))
+    setTile(*tileId, -1);
 }
 
 const MapMemory& MapMemory::empty() {
@@ -59,7 +162,7 @@ const MapMemory& MapMemory::empty() {
 }
 
 bool MapMemory::containsLevel(Level* l) const {
-  return table->containsLevel(l);
+  return levels.count(l->getUniqueId());
 }
 
 const HashSet<Position>& MapMemory::getUpdated(const Level* level) const {
@@ -19,9 +19,9 @@
 #include "position.h"
 #include "position_map.h"
 #include "hashing.h"
-
-class ViewObject;
-class ViewIndex;
+#include "flyweight_pool.h"
+#include "view_index.h"
+#include "view_object.h"
 
 class MapMemory {
   public:
@@ -31,15 +31,33 @@ class MapMemory {
   void clearUpdated(const Level*) const;
   void clearSquare(Position pos);
   static const MapMemory& empty();
-  optional<const ViewIndex&> getViewIndex(Position) const;
+  optional<ViewIndex> getViewIndex(Position) const;
+  bool contains(Position) const;
   bool containsLevel(Level*) const;
 
   template <class Archive>
   void serialize(Archive& ar, const unsigned int version);
 
   private:
+  // Remembered tiles are stored as ids of shared objects, so that repeated walls and floors take no extra space.
+  struct Tile {
+    int SERIAL(shell); // the index without its objects
+    std::array<int, EnumInfo<ViewLayer>::size> SERIAL(objects); // -1 if the layer is empty
+    std::uint8_t SERIAL(positionIds) = 0; // layers whose object's generic id is Position::getGenericId()
+    COMPARE_ALL(shell, objects, positionIds)
+    size_t getHash() const;
+  };
   void updateUpdated(Position);
-  optional<ViewIndex&> getViewIndex(Position);
-  HeapAllocated<PositionMap<ViewIndex>> SERIAL(table);
+  optional<int&> getTileId(Position);
+  optional<const int&> getTileId(Position) const;
+  int addTile(Tile);
+  void releaseTile(int id);
+  void setTile(int& tileId, int newId);
+  FlyweightPool<ViewIndex> SERIAL(shells);
+  FlyweightPool<ViewObject> SERIAL(objects);
+  FlyweightPool<Tile> SERIAL(tiles);
+  map<LevelId, Table<int>> SERIAL(levels);
   mutable map<int, PositionSet> updated;
 };
+
+CEREAL_CLASS_VERSION(MapMemory, 1)
@@ -4,6 +4,7 @@
 
 #include <cereal/cereal.hpp>
 #include "my_containers.h"
+#include "flat_hash.h"
 
 class MemUsageArchive : public cereal::OutputArchive<MemUsageArchive> {
   public:
@@ -130,6 +131,22 @@ void save(MemUsageArchive & ar1, unordered_set<T, U> const & bd) {
   }
 }
 
+template <class T, class U, class V> inline
+void save(MemUsageArchive & ar1, FlatHashMap<T, U, V> const & bd) {
+  ar1.addUsage((sizeof(T) + sizeof(U)) * bd.size());
+  for (auto& elem : bd) {
+    ar1(elem);
+  }
+}
+
+template <class T, class U> inline
+void save(MemUsageArchive & ar1, FlatHashSet<T, U> const & bd) {
+  ar1.addUsage(sizeof(T) * bd.size());
+  for (auto& elem : bd) {
+    ar1(elem);
+  }
+}
+
 template <class T, class U> inline
 void serialize(MemUsageArchive & ar1, pair<T, U> & bd) {
   ar1(bd.first, bd.second);
@@ -230,7 +230,8 @@ PTask MinionActivities::generateDropTask(Collective* collective, Creature* c, Mi
   return nullptr;
 }
 
-static vector<Position> limitToIndoors(const PositionSet& v) {
+template <typename PositionSetType>
+static vector<Position> limitToIndoors(const PositionSetType& v) {
   vector<Position> ret;
   ret.reserve(v.size());
   for (auto& pos : v)
@@ -239,23 +240,60 @@ static vector<Position> limitToIndoors(const PositionSet& v) {
   return ret;
 }
 
-const PositionSet& getIdlePositions(const Collective* collective, const Creature* c) {
-  auto& candidate = [&] () -> const PositionSet& {
-    auto& quarters = collective->getZones().getQuarters(c->getUniqueId());
-    if (!quarters.empty())
-      return quarters;
-    if (c->isAffected(LastingEffect::STEED))
-      return collective->getConstructions().getBuiltPositions(FurnitureType("STABLE"));
-    if (collective->hasTrait(c, MinionTrait::PRISONER))
-      return collective->getConstructions().getBuiltPositions(FurnitureType("PRISON"));
-    if (!collective->hasTrait(c, MinionTrait::NO_LEISURE_ZONE))
-      return collective->getZones().getPositions(ZoneId::LEISURE);
-    else
-      return collective->getTerritory().getAllAsSet();
-  }();
-  if (!candidate.empty())
-    return candidate;
-  return collective->getTerritory().getAllAsSet();
+// The candidate sets are of different types, so the chosen one is passed to fun.
+template <typename Fun>
+static PTask visitIdlePositions(const Collective* collective, const Creature* c, Fun fun) {
+  auto visitOrTerritory = [&] (const auto& candidate) {
+    if (!candidate.empty())
+      return fun(candidate);
+    return fun(collective->getTerritory().getAllAsSet());
+  };
+  auto& quarters = collective->getZones().getQuarters(c->getUniqueId());
+  if (!quarters.empty())
+    return fun(quarters);
+  if (c->isAffected(LastingEffect::STEED))
+    return visitOrTerritory(collective->getConstructions().getBuiltPositions(FurnitureType("STABLE")));
+  if (collective->hasTrait(c, MinionTrait::PRISONER))
+    return visitOrTerritory(collective->getConstructions().getBuiltPositions(FurnitureType("PRISON")));
+  if (!collective->hasTrait(c, MinionTrait::NO_LEISURE_ZONE))
+    return visitOrTerritory(collective->getZones().getPositions(ZoneId::LEISURE));
+  else
+    return fun(collective->getTerritory().getAllAsSet());
+}
+
+template <typename PositionSetType>
+static PTask getIdleTask(Collective* collective, Creature* c, const PositionSetType& myTerritory) {
+  if (c->isAutomaton() && myTerritory.count(c->getPosition()))
+    return Task::idle();
+  if (auto p = collective->getTerritory().getCentralPoint())
+    if (p->getLevel()->depth == 0)
+      if (!myTerritory.empty() && collective->getGame()->getSunlightInfo().getState() == SunlightState::NIGHT) {
+        if ((c->getPosition().isCovered() && myTerritory.count(c->getPosition()))) {
+          PROFILE_BLOCK("Stay in for the night");
+          return Task::idle();
+        }
+        auto indoors = limitToIndoors(myTerritory);
+        return Task::chain(Task::transferTo(collective->getModel()),
+            Task::stayIn(!indoors.empty() ? std::move(indoors) : myTerritory.asVector()));
+      }
+  auto& pigstyPos = collective->getConstructions().getBuiltPositions(FurnitureType("PIGSTY"));
+  if (pigstyPos.count(c->getPosition()) && !myTerritory.empty()) {
+    PROFILE_BLOCK("Leave pigsty");
+    return Task::doneWhen(Task::goTo(Random.choose(myTerritory.asVector())),
+        TaskPredicate::outsidePositions(c, pigstyPos));
+  }
+  auto& leaders = collective->getLeaders();
+  if (!myTerritory.empty()) {
+    PROFILE_BLOCK("Stay in territory");
+    return Task::chain(Task::transferTo(collective->getModel()), Task::stayIn(myTerritory.asVector()));
+  } else if (collective->getConfig().getFollowLeaderIfNoTerritory() && !leaders.empty()) {
+    PROFILE_BLOCK("Follow leader");
+    return Task::alwaysDone(Task::follow(leaders[0]));
+  }
+  {
+    PROFILE_BLOCK("Just idle");
+    return Task::idle();
+  }
 }
 
 PTask MinionActivities::generate(Collective* collective, Creature* c, MinionActivity activity) const {
@@ -266,38 +304,8 @@ PTask MinionActivities::generate(Collective* collective, Creature* c, MinionActi
       PROFILE_BLOCK("Idle");
       if (collective->getDancing().getTarget(c))
         return Task::dance(collective);
-      auto& myTerritory = getIdlePositions(collective, c);
-      if (c->isAutomaton() && myTerritory.count(c->getPosition()))
-        return Task::idle();
-      if (auto p = collective->getTerritory().getCentralPoint())
-        if (p->getLevel()->depth == 0)
-          if (!myTerritory.empty() && collective->getGame()->getSunlightInfo().getState() == SunlightState::NIGHT) {
-            if ((c->getPosition().isCovered() && myTerritory.count(c->getPosition()))) {
-              PROFILE_BLOCK("Stay in for the night");
-              return Task::idle();
-            }
-            auto indoors = limitToIndoors(myTerritory);
-            return Task::chain(Task::transferTo(collective->getModel()),
-                Task::stayIn(!indoors.empty() ? std::move(indoors) : myTerritory.asVector()));
-          }
-      auto& pigstyPos = collective->getConstructions().getBuiltPositions(FurnitureType("PIGSTY"));
-      if (pigstyPos.count(c->getPosition()) && !myTerritory.empty()) {
-        PROFILE_BLOCK("Leave pigsty");
-        return Task::doneWhen(Task::goTo(Random.choose(myTerritory)),
-            TaskPredicate::outsidePositions(c, pigstyPos));
-      }
-      auto& leaders = collective->getLeaders();
-      if (!myTerritory.empty()) {
-        PROFILE_BLOCK("Stay in territory");
-        return Task::chain(Task::transferTo(collective->getModel()), Task::stayIn(myTerritory.asVector()));
-      } else if (collective->getConfig().getFollowLeaderIfNoTerritory() && !leaders.empty()) {
-        PROFILE_BLOCK("Follow leader");
-        return Task::alwaysDone(Task::follow(leaders[0]));
-      }
-      {
-        PROFILE_BLOCK("Just idle");
-        return Task::idle();
-      }
+      return visitIdlePositions(collective, c,
+          [&] (const auto& myTerritory) { return getIdleTask(collective, c, myTerritory); });
     }
     case MinionActivityInfo::FURNITURE: {
       PROFILE_BLOCK("Furniture");
@@ -383,15 +391,18 @@ PTask MinionActivities::generate(Collective* collective, Creature* c, MinionActi
       return nullptr;
     case MinionActivityInfo::WORKER:
       switch (activity) {
-        case MinionActivity::WOODCUTTING:
+        case MinionActivity::WOODCUTTING: {
           PROFILE_BLOCK("Woodcutting");
           return Task::woodcutting(collective, 3);
-        case MinionActivity::MINING:
+        }
+        case MinionActivity::MINING: {
           PROFILE_BLOCK("Mining");
           return Task::mining(collective, 3);
-        case MinionActivity::LIGHTBRINGING:
+        }
+        case MinionActivity::LIGHTBRINGING: {
           PROFILE_BLOCK("Light bringing");
           return Task::lightBringing(collective, 3);
+        }
         default:
           return nullptr;
       }
@@ -67,6 +67,9 @@ void Model::serialize(Archive& ar, const unsigned int version) {
   ar & SUBCLASS(OwnedObject<Model>);
   ar(levels, collectives, timeQueue, deadCreatures, currentTime, game, lastTick, biomeId, position);
   ar(stairNavigation, cemetery, mainLevels, upLevels, eventGenerator, externalEnemies, defaultMusic, portals);
+  if (Archive::is_loading::value)
+    for (auto c : timeQueue->getAllCreatures())
+      scheduleTimeouts(c);
 }
 
 SERIALIZATION_CONSTRUCTOR_IMPL(Model)
@@ -140,7 +143,29 @@ bool Model::update(double totalTime) {
   return false;
 }
 
+void Model::addCreatureTimeout(Creature* c, GlobalTime time) {
+  creatureTimeouts.add(time, make_pair(c->getThis(), time));
+}
+
+void Model::scheduleTimeouts(Creature* c) {
+  c->scheduleTimeouts(this);
+  // A ridden steed is not in the time queue, but its effects still time out.
+  if (auto steed = c->getSteed())
+    steed->scheduleTimeouts(this);
+}
+
+void Model::processCreatureTimeouts() {
+  PROFILE;
+  for (auto& entry : creatureTimeouts.popExpired(getGame()->getGlobalTime())) {
+    auto& c = entry.first;
+    // Creatures that died or left the model are skipped, they will register again when added to another model.
+    if (c && !c->isDead() && c->getPosition().getModel() == this)
+      c->processTimeouts(entry.second);
+  }
+}
+
 void Model::tick(LocalTime time) { PROFILE
+  processCreatureTimeouts();
   for (Creature* c : timeQueue->getAllCreatures()) {
     c->tick();
   }
@@ -148,15 +173,9 @@ void Model::tick(LocalTime time) { PROFILE
     l->tick();
   for (PCollective& col : collectives)
     col->tick();
-  for (auto& l : levels)
-    for (auto v : l->territory.getBounds())
-      l->territory[v] = nullptr;
-  for (auto& col : collectives)
-    for (auto& pos : col->getTerritory().getAll()) {
-      auto& value = pos.getLevel()->territory[pos.getCoord()];
-      if (!value || value->getVillainType() != VillainType::PLAYER)
-        value = col.get();
-    }
+#ifndef RELEASE
+  checkTerritoryTable();
+#endif
   if (externalEnemies)
     externalEnemies->update(getGroundLevel(), time);
   stairNavigation.clear();
@@ -169,6 +188,7 @@ void Model::addCreature(PCreature c) {
 void Model::addCreature(PCreature c, TimeInterval delay) {
   if (auto game = getGame())
     c->setGlobalTime(getGame()->getGlobalTime());
+  scheduleTimeouts(c.get());
   timeQueue->addCreature(std::move(c), getLocalTime() + delay);
 }
 
@@ -344,10 +364,50 @@ Level* Model::getMainLevel(int depth) const {
 
 void Model::addCollective(PCollective col) {
   collectives.push_back(std::move(col));
+  for (auto& pos : collectives.back()->getTerritory().getAll())
+    updateTerritoryOwner(pos);
   if (game)
     game->addCollective(collectives.back().get());
 }
 
+// The player's collective owns contested squares, otherwise the one added last does.
+void Model::updateTerritoryOwner(Position pos) {
+  auto& value = pos.getLevel()->territory[pos.getCoord()];
+  value = nullptr;
+  for (auto& col : collectives)
+    if (col->getTerritory().contains(pos) && (!value || value->getVillainType() != VillainType::PLAYER))
+      value = col.get();
+}
+
+void Model::onTerritoryAdded(Collective* col, Position pos) {
+  auto& value = pos.getLevel()->territory[pos.getCoord()];
+  if (!value)
+    value = col;
+  else if (value != col)
+    updateTerritoryOwner(pos);
+}
+
+void Model::onTerritoryRemoved(Collective* col, Position pos) {
+  if (pos.getLevel()->territory[pos.getCoord()] == col)
+    updateTerritoryOwner(pos);
+}
+
+void Model::checkTerritoryTable() const {
+  PROFILE;
+  for (auto& l : levels) {
+    Table<Collective*> expected(l->territory.getBounds(), nullptr);
+    for (auto& col : collectives)
+      for (auto& pos : col->getTerritory().getAll())
+        if (pos.getLevel() == l.get()) {
+          auto& value = expected[pos.getCoord()];
+          if (!value || value->getVillainType() != VillainType::PLAYER)
+            value = col.get();
+        }
+    for (auto v : expected.getBounds())
+      CHECK(expected[v] == l->territory[v]) << "Territory table out of sync at " << v;
+  }
+}
+
 Level* Model::getGroundLevel() const {
   return mainLevels[0];
 }
@@ -433,9 +493,9 @@ const heap_optional<ExternalEnemies>& Model::getExternalEnemies() const {
   return externalEnemies;
 }
 
-void Model::addEvent(const GameEvent& e) {
+void Model::addEvent(const GameEvent& e, bool local) {
   PROFILE;
-  eventGenerator->addEvent(e);
+  eventGenerator->addEvent(e, local);
 }
 
 optional<MusicType> Model::getDefaultMusic() const {
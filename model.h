@@ -24,6 +24,7 @@
 #include "game_time.h"
 #include "biome_id.h"
 #include "movement_type.h"
+#include "timer_wheel.h"
 
 class Level;
 class ProgressMeter;
@@ -83,6 +84,10 @@ class Model : public OwnedObject<Model> {
   LevelId getUniqueId() const;
 
   void addCollective(PCollective);
+  // Keep Level::territory in sync with the collectives' territories.
+  void onTerritoryAdded(Collective*, Position);
+  void onTerritoryRemoved(Collective*, Position);
+  void updateTerritoryOwner(Position);
 
   int getSaveProgressCount() const;
 
@@ -94,13 +99,15 @@ class Model : public OwnedObject<Model> {
   void transferCreature(PCreature, Vec2 travelDir);
   void transferCreature(PCreature, const vector<Position>& destinations);
   bool canTransferCreature(Creature*, Vec2 travelDir);
+  // The creature's processTimeouts() will be called on the first tick after the given time.
+  void addCreatureTimeout(Creature*, GlobalTime);
 
   SERIALIZATION_DECL(Model)
 
   void discardForRetirement();
   void prepareForRetirement();
 
-  void addEvent(const GameEvent&);
+  void addEvent(const GameEvent&, bool local = true);
 
   Level* buildLevel(const ContentFactory*, LevelBuilder, PLevelMaker, int depth, TString name);
   Level* buildMainLevel(const ContentFactory*, LevelBuilder, PLevelMaker);
@@ -126,6 +133,7 @@ class Model : public OwnedObject<Model> {
   friend class ModelBuilder;
 
   PCreature makePlayer(int handicap);
+  void checkTerritoryTable() const;
 
   vector<PLevel> SERIAL(levels);
   vector<Level*> SERIAL(mainLevels);
@@ -148,5 +156,10 @@ class Model : public OwnedObject<Model> {
   int moveCounter = 0;
   optional<MusicType> SERIAL(defaultMusic);
   BiomeId SERIAL(biomeId);
+  // Holds the deadline of each entry, so that entries replaced by a newer schedule can be skipped.
+  // Rebuilt on load.
+  TimerWheel<pair<WeakPointer<Creature>, GlobalTime>> creatureTimeouts;
+  void scheduleTimeouts(Creature*);
+  void processCreatureTimeouts();
 };
 
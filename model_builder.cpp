@@ -162,7 +162,7 @@ PModel ModelBuilder::campaignSiteModel(EnemyId enemyId, VillainType type, TribeA
       enemyId.data());
 }
 
-void ModelBuilder::measureSiteGen(int numTries, vector<string> types, vector<BiomeId> biomes) {
+vector<size_t> ModelBuilder::measureSiteGen(int numTries, vector<string> types, vector<BiomeId> biomes) {
   if (types.empty()) {
     types = {"campaign_base", "tutorial", "zlevels"};
     for (auto id : enemyFactory->getAllIds()) {
@@ -171,19 +171,19 @@ void ModelBuilder::measureSiteGen(int numTries, vector<string> types, vector<Bio
         types.push_back(id.data());
     }
   }
-  vector<function<void()>> tasks;
+  vector<function<size_t()>> tasks;
   for (auto& type : types) {
     if (type == "campaign_base")
       for (auto alignment : ENUM_ALL(TribeAlignment))
         for (auto biome : biomes)
-          tasks.push_back([=] { measureModelGen(type + " (" + EnumInfo<TribeAlignment>::getString(alignment) + ", "
+          tasks.push_back([=] { return measureModelGen(type + " (" + EnumInfo<TribeAlignment>::getString(alignment) + ", "
               + biome.data() + ")", numTries,
-              [&] { tryCampaignBaseModel(alignment, none, biome, none); }); });
+              [&] { return tryCampaignBaseModel(alignment, none, biome, none); }); });
     else if (type == "zlevels") {
 //      FATAL << "Fix after adding z level groups";
       for (auto alignment : ENUM_ALL(TribeAlignment))
         for (int i : Range(1, 30))
-          tasks.push_back([=] { measureModelGen(type + " " + toString(i) +
+          tasks.push_back([=] { return measureModelGen(type + " " + toString(i) +
               " (" + EnumInfo<TribeAlignment>::getString(alignment) + ")",
               numTries,
               [&] {
@@ -193,23 +193,41 @@ void ModelBuilder::measureSiteGen(int numTries, vector<string> types, vector<Bio
                     EnemyAggressionLevel(0));
                 LevelBuilder(Random, contentFactory, size.x, size.y, true)
                     .build(contentFactory, model.get(), maker.maker.get(), 123);
+                return model;
               }); });
     }
     else if (type == "tutorial")
-      tasks.push_back([=] { measureModelGen(type, numTries, [&] { tryTutorialModel(none); }); });
+      tasks.push_back([=] { return measureModelGen(type, numTries, [&] { return tryTutorialModel(none); }); });
     else {
       auto id = EnemyId(type.data());
       for (auto alignment : ENUM_ALL(TribeAlignment))
-        tasks.push_back([=] { measureModelGen(type, numTries, [&] {
-            tryCampaignSiteModel(id, VillainType::LESSER, alignment, Random.choose(biomes), 0); }); });
+        tasks.push_back([=] { return measureModelGen(type, numTries, [&] {
+            return tryCampaignSiteModel(id, VillainType::LESSER, alignment, Random.choose(biomes), 0); }); });
     }
   }
+  vector<size_t> checksums;
   for (auto& t : tasks)
-    t();
+    checksums.push_back(t());
+  return checksums;
 }
 
-void ModelBuilder::measureModelGen(const string& name, int numTries, function<void()> genFun) {
+// Folds in what the levels look like, so that runs with the same seed can be compared.
+static size_t getChecksum(Model* model) {
+  size_t ret = 0;
+  for (auto level : model->getLevels()) {
+    for (Vec2 v : level->getBounds())
+      for (auto layer : ENUM_ALL(FurnitureLayer))
+        if (auto furniture = Position(v, level).getFurniture(layer))
+          ret = combineHash(ret, string(furniture->getType().data()));
+    for (auto creature : level->getAllCreatures())
+      ret = combineHash(ret, creature->getPosition().getCoord());
+  }
+  return ret;
+}
+
+size_t ModelBuilder::measureModelGen(const string& name, int numTries, function<PModel()> genFun) {
   int numSuccess = 0;
+  size_t checksum = 0;
   int maxT = 0;
   int minT = 1000000;
   double sumT = 0;
@@ -219,7 +237,8 @@ void ModelBuilder::measureModelGen(const string& name, int numTries, function<vo
     auto time = steady_clock::now();
 #endif
     try {
-      genFun();
+      auto model = genFun();
+      checksum = combineHash(checksum, getChecksum(model.get()));
       ++numSuccess;
       //std::cout << ".";
       //std::cout.flush();
@@ -235,7 +254,8 @@ void ModelBuilder::measureModelGen(const string& name, int numTries, function<vo
 #endif
   }
   USER_INFO << numSuccess << " / " << numTries << ". MinT: " <<
-    minT << ". MaxT: " << maxT << ". AvgT: " << sumT / numTries;
+    minT << ". MaxT: " << maxT << ". AvgT: " << sumT / numTries << ". Checksum: " << checksum;
+  return checksum;
 }
 
 void ModelBuilder::makeExtraLevel(Model* model, LevelConnection& connection, SettlementInfo& mainSettlement,
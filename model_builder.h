@@ -34,14 +34,14 @@ class ModelBuilder {
   PModel campaignSiteModel(EnemyId, VillainType, TribeAlignment, BiomeId, int difficulty);
   PModel tutorialModel(optional<KeeperBaseInfo>);
 
-  void measureSiteGen(int numTries, vector<string> types, vector<BiomeId> biomes);
+  vector<size_t> measureSiteGen(int numTries, vector<string> types, vector<BiomeId> biomes);
 
   PModel battleModel(const FilePath& levelPath, vector<PCreature> allies, vector<CreatureList> enemies);
 
   ~ModelBuilder();
 
   private:
-  void measureModelGen(const std::string& name, int numTries, function<void()> genFun);
+  size_t measureModelGen(const std::string& name, int numTries, function<PModel()> genFun);
   PModel tryCampaignBaseModel(TribeAlignment, optional<KeeperBaseInfo>, BiomeId, optional<ExternalEnemiesType>);
   PModel tryTutorialModel(optional<KeeperBaseInfo>);
   PModel tryCampaignSiteModel(EnemyId, VillainType, TribeAlignment, BiomeId, int difficulty);
@@ -194,7 +194,7 @@ class EffectsAI : public Behaviour {
             if (!effect->isOffensive() || !creature->getVisibleEnemies().empty()) {
               {
                 auto name = "Apply item ";// + item->getName();
-                PROFILE_BLOCK(name.data());
+                PROFILE_BLOCK(name);
               auto value = effect->shouldAIApply(creature, creature->getPosition());
               if (value > 0)
                 if (auto move = creature->applyItem(item))
@@ -202,7 +202,7 @@ class EffectsAI : public Behaviour {
               }
               {
               auto name = "Give item ";// + item->getName();
-              PROFILE_BLOCK(name.data());
+              PROFILE_BLOCK(name);
               for (Position pos : creature->getPosition().neighbors8())
                 if (Creature* c = pos.getCreature())
                   if (creature->isFriend(c) && effect->shouldAIApply(c, c->getPosition()) > 0 &&
@@ -6,3 +6,5 @@ class NameGeneratorId : public ContentId<NameGeneratorId> {
   public:
   using ContentId::ContentId;
 };
+
+CEREAL_CLASS_VERSION(NameGeneratorId, 1)
@@ -105,7 +105,10 @@ static void APIENTRY debugOutputCallback(GLenum source, GLenum type, GLuint id,
   char header[1024];
   snprintf(header, sizeof(header), "%sOpengl %s [%s] id:%d source:%s\n", isSevere ? "FATAL: " : "", debugTypeText(type),
            debugSeverityText(severity), id, debugSourceText(source));
-  (isSevere ? FatalLog : InfoLog).get() << header << message;
+  if (isSevere)
+    FatalLog.get() << header << message;
+  else
+    INFO << header << message;
 }
 #endif
 
@@ -0,0 +1,71 @@
+#include "stdafx.h"
+#include "perception_cache.h"
+#include "field_of_view.h"
+
+static constexpr int bucketSize = 16;
+
+PerceptionCache::PerceptionCache(Rectangle bounds)
+    : bounds(bounds), stamps(Rectangle((bounds.getSize() + Vec2(bucketSize - 1, bucketSize - 1)) / bucketSize), 0) {
+}
+
+Rectangle PerceptionCache::getBuckets(Rectangle area) const {
+  area = area.intersection(bounds);
+  return Rectangle((area.topLeft() - bounds.topLeft()) / bucketSize,
+      (area.bottomRight() - bounds.topLeft() - Vec2(1, 1)) / bucketSize + Vec2(1, 1));
+}
+
+void PerceptionCache::changed(Vec2 pos) {
+  if (pos.inRectangle(bounds))
+    stamps[(pos - bounds.topLeft()) / bucketSize] = ++counter;
+}
+
+void PerceptionCache::changed(Rectangle area) {
+  if (area.intersects(bounds)) {
+    ++counter;
+    for (Vec2 v : getBuckets(area))
+      stamps[v] = counter;
+  }
+}
+
+PerceptionCache::Entry& PerceptionCache::getEntry(const Creature* c, Vec2 position, GlobalTime time) {
+  auto& entryPtr = entries[c];
+  if (!entryPtr)
+    entryPtr = make_unique<Entry>();
+  auto& entry = *entryPtr;
+  auto isValid = [&] {
+    if (!entry.visible || entry.position != position || entry.time != time)
+      return false;
+    for (Vec2 v : getBuckets(Rectangle::centered(position, FieldOfView::sightRange)))
+      if (stamps[v] > entry.stamp)
+        return false;
+    return true;
+  };
+  if (!isValid()) {
+    entry.position = position;
+    entry.time = time;
+    entry.stamp = counter;
+    entry.visible = none;
+    entry.enemies = none;
+  }
+  return entry;
+}
+
+const vector<Creature*>& PerceptionCache::getVisibleCreatures(const Creature* c, Vec2 position, GlobalTime time,
+    const Compute& compute) {
+  auto& entry = getEntry(c, position, time);
+  if (!entry.visible)
+    entry.visible = compute();
+  return *entry.visible;
+}
+
+const vector<Creature*>& PerceptionCache::getVisibleEnemies(const Creature* c, Vec2 position, GlobalTime time,
+    const Compute& compute) {
+  auto& entry = getEntry(c, position, time);
+  if (!entry.enemies)
+    entry.enemies = compute();
+  return *entry.enemies;
+}
+
+void PerceptionCache::clear() {
+  entries.clear();
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "util.h"
+#include "game_time.h"
+
+class Creature;
+
+// Lists of creatures that each creature on a level can see, shared by all callers during a turn.
+// A list stays valid until the viewer moves, the turn changes, or something that affects perception
+// changes within sight range of the viewer: a creature moving or changing its state, or a square's
+// visibility or light changing. Changes are tracked per bucket of squares, so that a move somewhere
+// else on the level doesn't throw away the lists of every creature.
+class PerceptionCache {
+  public:
+  PerceptionCache(Rectangle bounds);
+
+  void changed(Vec2);
+  void changed(Rectangle);
+
+  using Compute = function<vector<Creature*>()>;
+  const vector<Creature*>& getVisibleCreatures(const Creature*, Vec2 position, GlobalTime, const Compute&);
+  const vector<Creature*>& getVisibleEnemies(const Creature*, Vec2 position, GlobalTime, const Compute&);
+
+  // Drops all lists. No list returned earlier may be in use.
+  void clear();
+
+  private:
+  struct Entry {
+    Vec2 position;
+    GlobalTime time;
+    int stamp;
+    optional<vector<Creature*>> visible;
+    optional<vector<Creature*>> enemies;
+  };
+  Entry& getEntry(const Creature*, Vec2 position, GlobalTime);
+  Rectangle getBuckets(Rectangle) const;
+  Rectangle bounds;
+  Table<int> stamps;
+  int counter = 0;
+  // Entries are heap allocated, so that the returned lists survive inserting other creatures' entries.
+  HashMap<const Creature*, unique_ptr<Entry>> entries;
+};
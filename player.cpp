@@ -94,6 +94,12 @@ Player::Player(Creature* c, SMapMemory memory, SMessageBuffer buf, SVisibilityMa
 Player::~Player() {
 }
 
+// The player doesn't resubscribe after travelling to another site.
+EventSubscription Player::getEventSubscription() {
+  using namespace EventInfo;
+  return {getEventMask<Projectile, CreatureKilled, CreatureAttacked, Alarm, FX>(), true};
+}
+
 void Player::onEvent(const GameEvent& event) {
   using namespace EventInfo;
   auto factory = getGame()->getContentFactory();
@@ -213,7 +219,7 @@ void Player::throwItem(Item* item, optional<Position> target) {
           PassableInfo::PASSABLE);
       for (auto v : passable.getBounds()) {
         Position pos(v, getLevel());
-        if (!creature->canSee(pos) && !getMemory().getViewIndex(pos))
+        if (!creature->canSee(pos) && !getMemory().contains(pos))
           passable[v] = PassableInfo::UNKNOWN;
         else if (pos.stopsProjectiles(creature->getVision().getId()))
           passable[v] = PassableInfo::NON_PASSABLE;
@@ -422,7 +428,7 @@ void Player::fireAction() {
       Table<PassableInfo> passable(Rectangle::centered(origin, spell->getRange()), PassableInfo::PASSABLE);
       for (auto v : passable.getBounds()) {
         Position pos(v, getLevel());
-        if (!creature->canSee(pos) && !getMemory().getViewIndex(pos))
+        if (!creature->canSee(pos) && !getMemory().contains(pos))
           passable[v] = PassableInfo::UNKNOWN;
         if (spell->isBlockedBy(creature, pos))
           passable[v] = PassableInfo::STOPS_HERE;
@@ -472,7 +478,7 @@ void Player::spellAction(int id) {
       Table<PassableInfo> passable(Rectangle::centered(origin, range), PassableInfo::PASSABLE);
       for (auto v : passable.getBounds()) {
         Position pos(v, getLevel());
-        if (!creature->canSee(pos) && !getMemory().getViewIndex(pos))
+        if (!creature->canSee(pos) && !getMemory().contains(pos))
           passable[v] = PassableInfo::UNKNOWN;
         if (spell->isBlockedBy(creature, pos))
           passable[v] = PassableInfo::STOPS_HERE;
@@ -626,7 +632,7 @@ void Player::updateUnknownLocations() {
   for (auto col : getModel()->getCollectives())
     if (!col->isConquered())
       if (auto& pos = col->getTerritory().getCentralPoint())
-        if (pos->isSameLevel(getLevel()) && !getMemory().getViewIndex(*pos))
+        if (pos->isSameLevel(getLevel()) && !getMemory().contains(*pos))
           locations.push_back(*pos);
   unknownLocations->update(locations);
 }
@@ -47,6 +47,7 @@ class Player : public Controller, public CreatureView, public EventListener<Play
       STutorial = nullptr);
 
   void onEvent(const GameEvent&);
+  static EventSubscription getEventSubscription();
   virtual void forceSteeds() const;
   virtual vector<Creature*> getTeam() const;
 
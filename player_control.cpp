@@ -2135,6 +2135,14 @@ void PlayerControl::addWindowMessage(ViewIdList viewId, const TString& message)
   getView()->windowedMessage(viewId, message);
 }
 
+// Conquered enemies and minion events come from all sites.
+EventSubscription PlayerControl::getEventSubscription() {
+  using namespace EventInfo;
+  return {getEventMask<Projectile, ConqueredEnemy, CreatureEvent, VisibilityChanged,
+      CreatureMoved, ItemsOwned, WonGame, RetiredGame, TechbookRead, CreatureStunned, CreatureKilled,
+      CreatureAttacked, FurnitureRemoved, FX, LeaderWounded>(), true};
+}
+
 void PlayerControl::onEvent(const GameEvent& event) {
   using namespace EventInfo;
   event.visit<void>(
@@ -2181,7 +2189,7 @@ void PlayerControl::onEvent(const GameEvent& event) {
           addMessage(PlayerMessage(info.message).setCreature(info.creature->getUniqueId()));
       },
       [&](const VisibilityChanged& info) {
-        visibilityMap->onVisibilityChanged(info.pos);
+        visibilityMap->onVisibilityChanged(info.level, info.positions);
       },
       [&](const CreatureMoved& info) {
         if (getCreatures().contains(info.creature))
@@ -2372,8 +2380,8 @@ void PlayerControl::getViewIndex(Vec2 pos, ViewIndex& index) const {
         if (auto& obj = furniture->getViewObject())
           if (index.hasObject(obj->layer()))
             index.getObject(obj->layer()).setClickAction(FurnitureClick::getClickAction(*clickType, position, furniture));
-      auto workshopType = furniture->getType() == FurnitureType("FURNACE")
-          ? WorkshopType("FURNACE")
+      auto workshopType = furniture->getType() == STATIC_ID(FurnitureType, "FURNACE")
+          ? STATIC_ID(WorkshopType, "FURNACE")
           : getGame()->getContentFactory()->getWorkshopType(furniture->getType());
       if (!!workshopType)
         index.setHighlight(HighlightType::CLICKABLE_FURNITURE);
@@ -2385,7 +2393,7 @@ void PlayerControl::getViewIndex(Vec2 pos, ViewIndex& index) const {
             if (collective->isActivityGood(c, *task, true))
               index.setHighlight(HighlightType::CREATURE_DROP);
       if (collective->getMaxPopulation() <= collective->getPopulationSize() &&
-          furniture->getType() == FurnitureType("TORTURE_TABLE"))
+          furniture->getType() == STATIC_ID(FurnitureType, "TORTURE_TABLE"))
         index.setHighlight(HighlightType::TORTURE_UNAVAILABLE);
       if (auto& obj = furniture->getViewObject()) {
         if (collective->usesEfficiency(furniture)) {
@@ -2397,7 +2405,7 @@ void PlayerControl::getViewIndex(Vec2 pos, ViewIndex& index) const {
       }
     }
     if (auto furniture = position.getFurniture(FurnitureLayer::FLOOR))
-      if (furniture->getType() == FurnitureType("PRISON") &&
+      if (furniture->getType() == STATIC_ID(FurnitureType, "PRISON") &&
           !position.isClosedOff(MovementType(MovementTrait::WALK).setPrisoner()))
         index.setHighlight(HighlightType::PRISON_NOT_CLOSED);
     if (auto furniture = position.getFurniture(FurnitureLayer::MIDDLE))
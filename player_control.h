@@ -92,6 +92,7 @@ class PlayerControl : public CreatureView, public CollectiveControl, public Even
   TribeAlignment getTribeAlignment() const;
 
   void onEvent(const GameEvent&);
+  static EventSubscription getEventSubscription();
   const vector<Creature*>& getControlled() const;
   void controlSingle(Creature*);
   void checkKeeperDanger();
@@ -1,6 +1,7 @@
 #include "stdafx.h"
 #include "position.h"
 #include "level.h"
+#include "light_engine.h"
 #include "square.h"
 #include "creature.h"
 #include "item.h"
@@ -61,6 +62,10 @@ Level* Position::getLevel() const {
   return level;
 }
 
+GenericId Position::getGenericId() const {
+  return level->getUniqueId() + coord.x * 2000 + coord.y;
+}
+
 Model* Position::getModel() const {
   PROFILE;
   if (isValid())
@@ -459,7 +464,7 @@ void Position::getViewIndex(ViewIndex& index, const Creature* viewer) const {
         index.removeObject(ViewLayer::ITEM);
       if (furniture->isVisibleTo(viewer) && furniture->getViewObject()) {
         auto obj = *furniture->getViewObject();
-        obj.setGenericId(level->getUniqueId() + coord.x * 2000 + coord.y);
+        obj.setGenericId(getGenericId());
         if (auto& id = furniture->getEmptyViewId())
           if (getInventory().isEmpty())
             obj.setId(*id);
@@ -1009,7 +1014,7 @@ bool Position::isCovered() const {
 
 bool Position::sunlightBurns() const {
   PROFILE;
-  return isValid() && !isCovered() && level->lightCapAmount[coord] >= 1 &&
+  return isValid() && !isCovered() && level->lightEngine->getLightCap(coord) >= 1 &&
       getGame()->getSunlightInfo().getState() == SunlightState::DAY && !getSquare()->hasSunlightBlockingGasAmount();
 }
 
@@ -1070,6 +1075,7 @@ void Position::updateConnectivity() const {
         elem.second.add(coord);
       else
         elem.second.remove(coord);
+    level->updateNavigationCosts(coord);
   }
   if (couldEnter != movementEventPredicate())
     if (auto game = getGame())
@@ -1155,17 +1161,21 @@ optional<DestroyAction> Position::getBestDestroyAction(const MovementType& movem
   return none;
 }
 
-double Position::getNavigationCost(const MovementType& movement, const Sectors& onltMovementSectors) const {
+double Position::getNavigationCostCalc(const MovementType& movement, const Sectors& movementSectors,
+    const Sectors& onlyMovementSectors) const {
+  PROFILE;
+  if (!movementSectors.contains(coord))
+    return ShortestPath::infinity;
+  if (onlyMovementSectors.contains(coord))
+    return 0;
+  return -1;
+}
+
+double Position::getDestroyOrBridgeCost(const MovementType& movement) const {
   PROFILE;
-  if (onltMovementSectors.contains(coord)) {
-    if (level->getSafeSquare(coord)->getCreature()) {
-      return 5.0;
-    } else
-      return 1.0;
-  }
   if (auto destroyAction = getBestDestroyAction(movement))
     return 1.0 + *getFurniture(FurnitureLayer::MIDDLE)->getStrength(*destroyAction) / 10;
-  if (movement.canBuildBridge() && canConstruct(FurnitureType("BRIDGE")) &&
+  if (movement.canBuildBridge() && canConstruct(STATIC_ID(FurnitureType, "BRIDGE")) &&
       !movement.isCompatible(getFurniture(FurnitureLayer::GROUND)->getTribe()))
     return 10;
   return ShortestPath::infinity;
@@ -1183,7 +1193,7 @@ bool Position::canNavigateCalc(const MovementType& type) const {
     for (DestroyAction action : type.getDestroyActions())
       if (furniture->canDestroy(*this, type, action))
         ignore = FurnitureLayer::MIDDLE;
-  if (type.canBuildBridge() && canConstruct(FurnitureType("BRIDGE")) &&
+  if (type.canBuildBridge() && canConstruct(STATIC_ID(FurnitureType, "BRIDGE")) &&
       !type.isCompatible(getFurniture(FurnitureLayer::GROUND)->getTribe()))
     return true;
   return canEnterEmptyCalc(type, ignore);
@@ -3,6 +3,7 @@
 #include "util.h"
 #include "stair_key.h"
 #include "game_time.h"
+#include "unique_entity.h"
 
 class Square;
 class Level;
@@ -45,6 +46,8 @@ class Position {
   Position withCoord(Vec2 newCoord) const;
   Vec2 getCoord() const;
   Level* getLevel() const;
+  // Identifies view objects of the furniture standing here.
+  GenericId getGenericId() const;
   optional<StairKey> getLandingLink() const;
   void setLandingLink(StairKey) const;
   void removeLandingLink() const;
@@ -122,7 +125,10 @@ class Position {
   bool canNavigate(const MovementType& type) const;
   bool canNavigateToOrNeighbor(Position, const MovementType&) const;
   bool canNavigateTo(Position, const MovementType&) const;
-  double getNavigationCost(const MovementType&, const Sectors& onltMovementSectors) const;
+  // See Level::getNavigationCosts().
+  double getNavigationCostCalc(const MovementType&, const Sectors& movementSectors,
+      const Sectors& onlyMovementSectors) const;
+  double getDestroyOrBridgeCost(const MovementType&) const;
   optional<DestroyAction> getBestDestroyAction(const MovementType&) const;
   vector<Position> getVisibleTiles(const Vision&);
   void updateConnectivity() const;
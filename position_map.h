@@ -19,6 +19,9 @@ class PositionMap {
   void erase(Position);
   void limitToModel(const Model*);
   bool containsLevel(const Level*) const;
+  const map<LevelId, Table<heap_optional<T>>>& getTables() const {
+    return tables;
+  }
 
   SERIALIZATION_DECL(PositionMap)
 
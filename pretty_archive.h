@@ -268,8 +268,9 @@ inline void serialize(Archive& ar1, VectorWithRoundBrackets<T>& v) {
   ar1(v.v);
 }
 
-template <typename T, typename H>
-inline void serialize(PrettyInputArchive& ar1, unordered_set<T, H>& v) {
+template <typename S>
+inline void serializeSet(PrettyInputArchive& ar1, S& v) {
+  using T = typename S::key_type;
   if (!ar1.eatMaybe("append"))
     v.clear();
   auto bracketType = BracketType::CURLY;
@@ -282,6 +283,16 @@ inline void serialize(PrettyInputArchive& ar1, unordered_set<T, H>& v) {
   ar1.closeBracket(bracketType);
 }
 
+template <typename T, typename H>
+inline void serialize(PrettyInputArchive& ar1, unordered_set<T, H>& v) {
+  serializeSet(ar1, v);
+}
+
+template <typename T, typename H>
+inline void serialize(PrettyInputArchive& ar1, FlatHashSet<T, H>& v) {
+  serializeSet(ar1, v);
+}
+
 template <typename T, std::size_t N>
 inline void serialize(PrettyInputArchive& ar1, array<T, N>& a) {
   ar1.openBracket(BracketType::CURLY);
@@ -346,6 +357,11 @@ inline void serialize(PrettyInputArchive& ar1, unordered_map<T, U, H>& m) {
   serializeMap(ar1, m);
 }
 
+template <typename T, typename U, typename H>
+inline void serialize(PrettyInputArchive& ar1, FlatHashMap<T, U, H>& m) {
+  serializeMap(ar1, m);
+}
+
 template <typename T, typename U>
 inline void serialize(PrettyInputArchive& ar1, EnumMap<T, U>& m) {
   if (!ar1.eatMaybe("append"))
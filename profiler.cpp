@@ -0,0 +1,213 @@
+#include "stdafx.h"
+#include "profiler.h"
+#include "debug.h"
+#include "util.h"
+
+std::atomic<bool> Profiler::running(false);
+
+static std::atomic<bool> hotkeyEnabled(false);
+
+void Profiler::setHotkeyEnabled(bool enabled) {
+  hotkeyEnabled = enabled;
+}
+
+bool Profiler::isHotkeyEnabled() {
+  return hotkeyEnabled;
+}
+
+static std::int64_t getProfilerTime() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+namespace {
+
+struct ProfileEvent {
+  const char* name;
+  std::int64_t start;
+  std::int64_t duration;
+  std::int64_t childTime;
+};
+
+// Written only by the thread that owns it. The events are allocated when the thread first records
+// something, and the buffer is emptied by its thread when it records in a new session.
+struct ProfileBuffer {
+  static constexpr int capacity = 1 << 18;
+  unique_ptr<ProfileEvent[]> events;
+  std::atomic<int> size = {0};
+  std::atomic<int> session = {-1};
+  int threadId;
+  int numDropped = 0;
+};
+
+struct ProfilerState {
+  std::mutex mutex;
+  vector<unique_ptr<ProfileBuffer>> buffers;
+  std::unordered_set<string> names;
+  std::atomic<int> session = {0};
+  std::int64_t startTime = 0;
+};
+
+}
+
+static ProfilerState& getState() {
+  static ProfilerState state;
+  return state;
+}
+
+#ifndef EASY_PROFILER
+
+static thread_local ProfileBuffer* threadBuffer = nullptr;
+static thread_local ProfileScope* currentScope = nullptr;
+
+static ProfileBuffer* getThreadBuffer() {
+  if (!threadBuffer) {
+    auto& state = getState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.buffers.push_back(make_unique<ProfileBuffer>());
+    threadBuffer = state.buffers.back().get();
+    threadBuffer->threadId = state.buffers.size();
+    threadBuffer->events.reset(new ProfileEvent[ProfileBuffer::capacity]);
+  }
+  return threadBuffer;
+}
+
+const char* ProfileScope::intern(const char* name) {
+  auto& state = getState();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  return state.names.insert(name).first->c_str();
+}
+
+void ProfileScope::begin() {
+  parent = currentScope;
+  currentScope = this;
+  childTime = 0;
+  startTime = getProfilerTime();
+}
+
+void ProfileScope::end() {
+  auto duration = getProfilerTime() - startTime;
+  currentScope = parent;
+  if (parent)
+    parent->childTime += duration;
+  auto buffer = getThreadBuffer();
+  int session = getState().session.load(std::memory_order_relaxed);
+  if (buffer->session != session) {
+    buffer->session = session;
+    buffer->numDropped = 0;
+    buffer->size.store(0, std::memory_order_relaxed);
+  }
+  int size = buffer->size.load(std::memory_order_relaxed);
+  if (size == ProfileBuffer::capacity) {
+    ++buffer->numDropped;
+    return;
+  }
+  buffer->events[size] = ProfileEvent{name, startTime, duration, childTime};
+  buffer->size.store(size + 1, std::memory_order_release);
+}
+
+#endif
+
+void Profiler::start() {
+  if (isRunning())
+    return;
+  auto& state = getState();
+  {
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.startTime = getProfilerTime();
+    ++state.session;
+  }
+  running = true;
+  INFO << "Profiler started";
+}
+
+static void writeJsonString(ostream& out, const char* s) {
+  out << '"';
+  for (; *s; ++s)
+    if (*s == '"' || *s == '\\')
+      out << '\\' << *s;
+    else if ((unsigned char) *s >= 0x20)
+      out << *s;
+  out << '"';
+}
+
+void Profiler::stop(const string& tracePath, const string& tablePath) {
+  if (!isRunning())
+    return;
+  running = false;
+  auto& state = getState();
+  struct ThreadEvents {
+    int threadId;
+    vector<ProfileEvent> events;
+    int numDropped;
+  };
+  vector<ThreadEvents> threads;
+  std::int64_t startTime;
+  {
+    std::lock_guard<std::mutex> lock(state.mutex);
+    startTime = state.startTime;
+    for (auto& buffer : state.buffers)
+      if (buffer->session == state.session) {
+        int size = buffer->size.load(std::memory_order_acquire);
+        threads.push_back(ThreadEvents{buffer->threadId,
+            vector<ProfileEvent>(buffer->events.get(), buffer->events.get() + size), buffer->numDropped});
+      }
+  }
+  struct ScopeStats {
+    int count = 0;
+    std::int64_t total = 0;
+    std::int64_t self = 0;
+    std::int64_t max = 0;
+  };
+  std::unordered_map<const char*, ScopeStats> stats;
+  int numDropped = 0;
+  ofstream trace(tracePath);
+  trace << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool first = true;
+  for (auto& thread : threads) {
+    numDropped += thread.numDropped;
+    for (auto& event : thread.events) {
+      // Scopes that were entered before the profiler was started.
+      if (event.start < startTime)
+        continue;
+      auto& scope = stats[event.name];
+      ++scope.count;
+      scope.total += event.duration;
+      scope.self += event.duration - event.childTime;
+      scope.max = max(scope.max, event.duration);
+      if (!first)
+        trace << ",\n";
+      first = false;
+      trace << "{\"name\":";
+      writeJsonString(trace, event.name);
+      trace << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread.threadId
+          << ",\"ts\":" << double(event.start - startTime) / 1000 << ",\"dur\":" << double(event.duration) / 1000 << "}";
+    }
+  }
+  trace << "]}\n";
+  vector<pair<const char*, ScopeStats>> sorted(stats.begin(), stats.end());
+  std::sort(sorted.begin(), sorted.end(),
+      [](const auto& s1, const auto& s2) { return s1.second.self > s2.second.self; });
+  ofstream table(tablePath);
+  table << "Profiled " << double(getProfilerTime() - startTime) / 1000000 << " ms";
+  if (numDropped > 0)
+    table << ", " << numDropped << " scopes dropped because of full buffers";
+  table << "\n\n";
+  char line[64];
+  snprintf(line, sizeof(line), "%10s %12s %12s %10s %10s  ", "calls", "self ms", "total ms", "avg us", "max us");
+  table << line << "scope\n";
+  for (auto& elem : sorted) {
+    auto& scope = elem.second;
+    snprintf(line, sizeof(line), "%10d %12.3f %12.3f %10.2f %10.2f  ", scope.count, double(scope.self) / 1000000,
+        double(scope.total) / 1000000, double(scope.total) / scope.count / 1000, double(scope.max) / 1000);
+    table << line << elem.first << "\n";
+  }
+  INFO << "Profile written to " << tracePath << " and " << tablePath;
+}
+
+void Profiler::toggle() {
+  if (isRunning())
+    stop();
+  else
+    start();
+}
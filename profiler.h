@@ -1,5 +1,29 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Built-in profiler, used when the game isn't built with easy_profiler. While it's running, every scope
+// marked with PROFILE or PROFILE_BLOCK is recorded into a preallocated buffer of the thread that ran it.
+// Stopping it writes a trace that can be opened in chrome://tracing or Perfetto, and a table with
+// the time spent in each scope.
+class Profiler {
+  public:
+  static void start();
+  static void stop(const std::string& tracePath = "profile.json", const std::string& tablePath = "profile.txt");
+  static void toggle();
+  static bool isRunning() {
+    return running.load(std::memory_order_relaxed);
+  }
+  // Whether the player may start and stop the profiler with a hotkey.
+  static void setHotkeyEnabled(bool);
+  static bool isHotkeyEnabled();
+
+  private:
+  static std::atomic<bool> running;
+};
+
 #ifdef EASY_PROFILER
 #define BUILD_WITH_EASY_PROFILER
 
@@ -16,8 +40,48 @@
 */
 #else
 
-#define PROFILE
-#define PROFILE_BLOCK(...)
+class ProfileScope {
+  public:
+  // String literals live as long as the program, other names have to be copied.
+  template <std::size_t N>
+  ProfileScope(const char (&name)[N]) : name(Profiler::isRunning() ? name : nullptr) {
+    if (this->name)
+      begin();
+  }
+
+  ProfileScope(const char* name) : name(Profiler::isRunning() ? intern(name) : nullptr) {
+    if (this->name)
+      begin();
+  }
+
+  ProfileScope(const ProfileScope&) = delete;
+
+  ~ProfileScope() {
+    if (name)
+      end();
+  }
+
+  private:
+  static const char* intern(const char*);
+  void begin();
+  void end();
+  const char* name;
+  std::int64_t startTime;
+  std::int64_t childTime;
+  ProfileScope* parent;
+};
+
+#define PROFILER_CONCAT2(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT2(a, b)
+
+#ifdef _MSC_VER
+#define PROFILER_FUNCTION __FUNCSIG__
+#else
+#define PROFILER_FUNCTION __PRETTY_FUNCTION__
+#endif
+
+#define PROFILE ProfileScope PROFILER_CONCAT(profileScope, __COUNTER__)(PROFILER_FUNCTION);
+#define PROFILE_BLOCK(name) ProfileScope PROFILER_CONCAT(profileScope, __COUNTER__)(name);
 #define ENABLE_PROFILER
 
 #endif
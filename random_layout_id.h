@@ -6,3 +6,5 @@ class RandomLayoutId : public ContentId<RandomLayoutId> {
   public:
   using ContentId::ContentId;
 };
+
+CEREAL_CLASS_VERSION(RandomLayoutId, 1)
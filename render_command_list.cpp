@@ -0,0 +1,225 @@
+#include "stdafx.h"
+#include "render_command_list.h"
+#include "clock.h"
+
+static Rectangle getBounds(const RenderPoint* points, int num, float margin = 0) {
+  float minX = points[0].x, maxX = points[0].x, minY = points[0].y, maxY = points[0].y;
+  for (int i : Range(1, num)) {
+    minX = min(minX, points[i].x);
+    maxX = max(maxX, points[i].x);
+    minY = min(minY, points[i].y);
+    maxY = max(maxY, points[i].y);
+  }
+  int px = floorf(minX - margin);
+  int py = floorf(minY - margin);
+  // Even an empty command covers a pixel, so that it never looks disjoint from what it's drawn over.
+  return Rectangle(px, py, max<int>(px + 1, ceilf(maxX + margin)), max<int>(py + 1, ceilf(maxY + margin)));
+}
+
+RenderCommand& RenderCommandList::add(RenderCommand::Type type) {
+  commands.emplace_back();
+  auto& ret = commands.back();
+  ret.type = type;
+  return ret;
+}
+
+void RenderCommandList::addSprite(unsigned int texture, Vec2 textureSize, Vec2 a, Vec2 b, Vec2 c, Vec2 d,
+    Vec2 p, Vec2 k, Color color) {
+  auto& command = add(RenderCommand::SPRITE);
+  command.texture = texture;
+  command.color = color;
+  Vec2 corners[] = {a, b, c, d};
+  Vec2 texCoords[] = {p, Vec2(k.x, p.y), k, Vec2(p.x, k.y)};
+  for (int i : Range(4)) {
+    command.corners[i] = RenderPoint{float(corners[i].x), float(corners[i].y)};
+    command.texCoords[i] = RenderPoint{float(texCoords[i].x) / textureSize.x, float(texCoords[i].y) / textureSize.y};
+  }
+  command.bounds = getBounds(command.corners, 4);
+}
+
+void RenderCommandList::addQuad(RenderPoint a, RenderPoint b, RenderPoint c, RenderPoint d, Color color) {
+  auto& command = add(RenderCommand::QUAD);
+  command.color = color;
+  command.corners[0] = a;
+  command.corners[1] = b;
+  command.corners[2] = c;
+  command.corners[3] = d;
+  command.bounds = getBounds(command.corners, 4);
+}
+
+void RenderCommandList::addOutline(RenderPoint a, RenderPoint b, RenderPoint c, RenderPoint d, Color color) {
+  auto& command = add(RenderCommand::OUTLINE);
+  command.color = color;
+  command.corners[0] = a;
+  command.corners[1] = b;
+  command.corners[2] = c;
+  command.corners[3] = d;
+  command.bounds = getBounds(command.corners, 4, 1);
+}
+
+void RenderCommandList::addPoint(Vec2 pos, Color color, int size) {
+  auto& command = add(RenderCommand::POINT);
+  command.color = color;
+  command.size = size;
+  command.corners[0] = RenderPoint{float(pos.x), float(pos.y)};
+  command.bounds = getBounds(command.corners, 1, float(size) / 2);
+}
+
+void RenderCommandList::addText(int font, float size, RenderPoint pos, Color color, const string& text,
+    Rectangle bounds) {
+  auto& command = add(RenderCommand::TEXT);
+  command.font = font;
+  command.size = size;
+  command.color = color;
+  command.corners[0] = pos;
+  command.text = text;
+  command.bounds = bounds;
+}
+
+void RenderCommandList::setScissor(optional<Rectangle> scissor) {
+  add(RenderCommand::SCISSOR).scissor = scissor;
+}
+
+void RenderCommandList::pushLayer() {
+  add(RenderCommand::PUSH_LAYER);
+}
+
+void RenderCommandList::popLayer(bool scissorEnabled) {
+  add(RenderCommand::POP_LAYER).scissorEnabled = scissorEnabled;
+}
+
+bool RenderCommandList::isEmpty() const {
+  return commands.empty();
+}
+
+void RenderCommandList::clear() {
+  commands.clear();
+  batches.clear();
+  order.clear();
+  numUnmergedBatches = 0;
+}
+
+static bool canBatch(const RenderCommand& c1, const RenderCommand& c2) {
+  if (c1.type != c2.type)
+    return false;
+  switch (c1.type) {
+    case RenderCommand::SPRITE:
+      return c1.texture == c2.texture;
+    case RenderCommand::QUAD:
+    case RenderCommand::OUTLINE:
+      return true;
+    case RenderCommand::POINT:
+      return c1.size == c2.size;
+    case RenderCommand::TEXT:
+      return c1.color == c2.color;
+    default:
+      return false;
+  }
+}
+
+static bool isBarrier(const RenderCommand& c) {
+  return c.type == RenderCommand::SCISSOR || c.type == RenderCommand::PUSH_LAYER || c.type == RenderCommand::POP_LAYER;
+}
+
+void RenderCommandList::makeBatches() {
+  auto startTime = Clock::getRealMicros();
+  struct BatchInfo {
+    int first;
+    int size;
+    Rectangle bounds;
+  };
+  vector<BatchInfo> info;
+  vector<int> batchIndex(commands.size());
+  // Looking further back than this rarely finds anything, and would make long frames quadratic.
+  const int maxLookBack = 64;
+  int segmentStart = 0;
+  numUnmergedBatches = 0;
+  for (int i : All(commands)) {
+    auto& command = commands[i];
+    if (i == 0 || !canBatch(commands[i - 1], command))
+      ++numUnmergedBatches;
+    optional<int> batch;
+    if (!isBarrier(command))
+      for (int j = info.size() - 1; j >= max(segmentStart, info.size() - maxLookBack); --j) {
+        if (canBatch(commands[info[j].first], command)) {
+          batch = j;
+          break;
+        }
+        if (info[j].bounds.intersects(command.bounds))
+          break;
+      }
+    if (batch) {
+      auto& b = info[*batch].bounds;
+      b = Rectangle(min(b.left(), command.bounds.left()), min(b.top(), command.bounds.top()),
+          max(b.right(), command.bounds.right()), max(b.bottom(), command.bounds.bottom()));
+      ++info[*batch].size;
+    } else {
+      batch = info.size();
+      info.push_back(BatchInfo{i, 1, command.bounds});
+      if (isBarrier(command))
+        segmentStart = info.size();
+    }
+    batchIndex[i] = *batch;
+  }
+  batches.clear();
+  int begin = 0;
+  for (auto& elem : info) {
+    batches.push_back(Batch{commands[elem.first].type, begin, begin});
+    begin += elem.size;
+  }
+  order.resize(commands.size());
+  for (int i : All(commands))
+    order[batches[batchIndex[i]].end++] = i;
+  batchingTime = Clock::getRealMicros() - startTime;
+}
+
+const vector<RenderCommandList::Batch>& RenderCommandList::getBatches() const {
+  return batches;
+}
+
+const vector<int>& RenderCommandList::getOrder() const {
+  return order;
+}
+
+const vector<RenderCommand>& RenderCommandList::getCommands() const {
+  return commands;
+}
+
+int RenderCommandList::getNumUnmergedBatches() const {
+  return numUnmergedBatches;
+}
+
+microseconds RenderCommandList::getBatchingTime() const {
+  return batchingTime;
+}
+
+RecordingRenderBackend::RecordingRenderBackend(Vec2 size, RenderBackend* next) : screenSize(size), next(next) {
+}
+
+void RecordingRenderBackend::draw(const RenderCommandList& list) {
+  auto& commands = list.getCommands();
+  current.numCommands += commands.size();
+  current.numBatches += list.getBatches().size();
+  current.numUnmergedBatches += list.getNumUnmergedBatches();
+  for (auto& batch : list.getBatches())
+    if (batch.type == RenderCommand::SPRITE)
+      ++current.numSpriteBatches;
+  Rectangle screen(screenSize);
+  for (auto& command : commands)
+    if (!isBarrier(command))
+      current.overdraw += double(command.bounds.intersection(screen).area()) / screen.area();
+  current.batchingTime += list.getBatchingTime();
+  if (next)
+    next->draw(list);
+}
+
+void RecordingRenderBackend::endFrame() {
+  frames.push_back(current);
+  current = FrameStats();
+  if (next)
+    next->endFrame();
+}
+
+const vector<RecordingRenderBackend::FrameStats>& RecordingRenderBackend::getFrames() const {
+  return frames;
+}
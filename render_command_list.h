@@ -0,0 +1,108 @@
+#pragma once
+
+#include "stdafx.h"
+#include "util.h"
+#include "color.h"
+
+struct RenderPoint {
+  float x, y;
+};
+
+struct RenderCommand {
+  enum Type { SPRITE, QUAD, OUTLINE, POINT, TEXT, SCISSOR, PUSH_LAYER, POP_LAYER };
+  Type type;
+  Color color;
+  RenderPoint corners[4];
+  // Normalized texture coordinates of the corners of a sprite.
+  RenderPoint texCoords[4];
+  unsigned int texture = 0;
+  // Point size, or font size of a text.
+  float size = 0;
+  int font = 0;
+  string text;
+  // In window pixels, none turns the scissor test off.
+  optional<Rectangle> scissor;
+  // Whether popping a layer turns the scissor test back on.
+  bool scissorEnabled = false;
+  // Covers everything the command draws. Commands whose bounds don't intersect can be drawn in any order.
+  Rectangle bounds;
+};
+
+// Collects the drawing commands of a frame and groups them into batches that a backend can draw with a single
+// state change each. A command joins an earlier batch with the same texture, color or point size if it doesn't
+// overlap anything drawn in between, so the frame looks the same as if the commands were drawn in order.
+// Scissor and layer commands are never moved across.
+class RenderCommandList {
+  public:
+  void addSprite(unsigned int texture, Vec2 textureSize, Vec2 a, Vec2 b, Vec2 c, Vec2 d, Vec2 p, Vec2 k, Color);
+  void addQuad(RenderPoint a, RenderPoint b, RenderPoint c, RenderPoint d, Color);
+  // Two pixels wide closed line.
+  void addOutline(RenderPoint a, RenderPoint b, RenderPoint c, RenderPoint d, Color);
+  void addPoint(Vec2, Color, int size);
+  // The position is the start of the baseline, the bounds cover the text.
+  void addText(int font, float size, RenderPoint pos, Color, const string&, Rectangle bounds);
+  void setScissor(optional<Rectangle>);
+  void pushLayer();
+  void popLayer(bool scissorEnabled);
+
+  bool isEmpty() const;
+  void clear();
+
+  struct Batch {
+    RenderCommand::Type type;
+    int begin;
+    int end;
+  };
+  // Groups the commands into batches. The commands of a batch are getOrder()[begin] to getOrder()[end - 1].
+  void makeBatches();
+  const vector<Batch>& getBatches() const;
+  const vector<int>& getOrder() const;
+  const vector<RenderCommand>& getCommands() const;
+  // The number of batches if every change of texture, color or point size started a new one.
+  int getNumUnmergedBatches() const;
+  // The time it took to make the batches.
+  microseconds getBatchingTime() const;
+
+  private:
+  RenderCommand& add(RenderCommand::Type);
+  vector<RenderCommand> commands;
+  vector<Batch> batches;
+  vector<int> order;
+  int numUnmergedBatches = 0;
+  microseconds batchingTime;
+};
+
+class RenderBackend {
+  public:
+  // Draws the batches of the list.
+  virtual void draw(const RenderCommandList&) = 0;
+  virtual void endFrame() {}
+  virtual ~RenderBackend() {}
+};
+
+// Keeps statistics of every frame instead of drawing, or on top of drawing with another backend. Needs no
+// window, so drawing can be measured and tested on machines without a GPU.
+class RecordingRenderBackend : public RenderBackend {
+  public:
+  RecordingRenderBackend(Vec2 screenSize, RenderBackend* next = nullptr);
+
+  struct FrameStats {
+    int numCommands = 0;
+    int numBatches = 0;
+    int numUnmergedBatches = 0;
+    int numSpriteBatches = 0;
+    // The area covered by the bounds of all drawing commands, divided by the screen area.
+    double overdraw = 0;
+    microseconds batchingTime = microseconds(0);
+  };
+
+  virtual void draw(const RenderCommandList&) override;
+  virtual void endFrame() override;
+  const vector<FrameStats>& getFrames() const;
+
+  private:
+  Vec2 screenSize;
+  RenderBackend* next;
+  FrameStats current;
+  vector<FrameStats> frames;
+};
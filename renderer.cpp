@@ -29,37 +29,104 @@
 #include "tileset.h"
 #include "steam_input.h"
 
-void Renderer::renderDeferredSprites() {
-  static vector<SDL::GLfloat> vertices;
-  static vector<SDL::GLfloat> texCoords;
-  static vector<SDL::GLfloat> colors;
-  vertices.clear();
-  texCoords.clear();
-  colors.clear();
-  auto addVertex = [&](Vec2 v, int texX, int texY, Vec2 texSize, Color color) {
-    vertices.push_back(v.x);
-    vertices.push_back(v.y);
-    texCoords.push_back(((float)texX) / texSize.x);
-    texCoords.push_back(((float)texY) / texSize.y);
-    colors.push_back(((float) color.r) / 255);
-    colors.push_back(((float) color.g) / 255);
-    colors.push_back(((float) color.b) / 255);
-    colors.push_back(((float) color.a) / 255);
-  };
-  for (auto& elem : deferredSprites) {
-    auto add = [&](Vec2 v, int texX, int texY, const DeferredSprite& draw) {
-      addVertex(v, texX, texY, draw.realSize, draw.color.value_or(Color::WHITE));
-    };
-    add(elem.a, elem.p.x, elem.p.y, elem);
-    add(elem.b, elem.k.x, elem.p.y, elem);
-    add(elem.c, elem.k.x, elem.k.y, elem);
-    add(elem.a, elem.p.x, elem.p.y, elem);
-    add(elem.c, elem.k.x, elem.k.y, elem);
-    add(elem.d, elem.p.x, elem.k.y, elem);
-  }
-  if (!vertices.empty()) {
+namespace {
+class GLRenderBackend : public RenderBackend {
+  public:
+  GLRenderBackend(sth_stash* fontStash) : fontStash(fontStash) {}
+
+  virtual void draw(const RenderCommandList& list) override {
+    auto& commands = list.getCommands();
+    auto& order = list.getOrder();
+    for (auto& batch : list.getBatches()) {
+      auto& first = commands[order[batch.begin]];
+      auto forEach = [&] (auto fun) {
+        for (int i : Range(batch.begin, batch.end))
+          fun(commands[order[i]]);
+      };
+      switch (batch.type) {
+        case RenderCommand::SPRITE:
+          drawSprites(first.texture, batch, list);
+          break;
+        case RenderCommand::QUAD:
+          SDL::glBegin(GL_QUADS);
+          forEach([] (const RenderCommand& command) {
+            glColor(command.color);
+            for (auto& v : command.corners)
+              SDL::glVertex2f(v.x, v.y);
+          });
+          SDL::glEnd();
+          break;
+        case RenderCommand::OUTLINE:
+          SDL::glLineWidth(2);
+          SDL::glBegin(GL_LINES);
+          forEach([] (const RenderCommand& command) {
+            glColor(command.color);
+            for (int i : Range(4)) {
+              SDL::glVertex2f(command.corners[i].x, command.corners[i].y);
+              SDL::glVertex2f(command.corners[(i + 1) % 4].x, command.corners[(i + 1) % 4].y);
+            }
+          });
+          SDL::glEnd();
+          break;
+        case RenderCommand::POINT:
+          SDL::glPointSize(first.size);
+          SDL::glBegin(GL_POINTS);
+          forEach([] (const RenderCommand& command) {
+            glColor(command.color);
+            SDL::glVertex2f(command.corners[0].x, command.corners[0].y);
+          });
+          SDL::glEnd();
+          break;
+        case RenderCommand::TEXT:
+          sth_begin_draw(fontStash);
+          glColor(first.color);
+          forEach([this] (const RenderCommand& command) {
+            sth_draw_text(fontStash, command.font, command.size, command.corners[0].x, command.corners[0].y,
+                command.text.c_str(), nullptr);
+          });
+          sth_end_draw(fontStash);
+          break;
+        case RenderCommand::SCISSOR:
+          if (auto& rect = first.scissor) {
+            SDL::glScissor(rect->left(), rect->top(), rect->width(), rect->height());
+            SDL::glEnable(GL_SCISSOR_TEST);
+          } else
+            SDL::glDisable(GL_SCISSOR_TEST);
+          break;
+        case RenderCommand::PUSH_LAYER:
+          SDL::glPushMatrix();
+          SDL::glTranslated(0, 0, 1);
+          SDL::glDisable(GL_SCISSOR_TEST);
+          break;
+        case RenderCommand::POP_LAYER:
+          SDL::glPopMatrix();
+          if (first.scissorEnabled)
+            SDL::glEnable(GL_SCISSOR_TEST);
+          break;
+      }
+    }
     CHECK_OPENGL_ERROR();
-    SDL::glBindTexture(GL_TEXTURE_2D, *currentTexture);
+  }
+
+  private:
+  void drawSprites(SDL::GLuint texture, const RenderCommandList::Batch& batch, const RenderCommandList& list) {
+    vertices.clear();
+    texCoords.clear();
+    colors.clear();
+    for (int i : Range(batch.begin, batch.end)) {
+      auto& command = list.getCommands()[list.getOrder()[i]];
+      for (int corner : {0, 1, 2, 0, 2, 3}) {
+        vertices.push_back(command.corners[corner].x);
+        vertices.push_back(command.corners[corner].y);
+        texCoords.push_back(command.texCoords[corner].x);
+        texCoords.push_back(command.texCoords[corner].y);
+        colors.push_back(((float) command.color.r) / 255);
+        colors.push_back(((float) command.color.g) / 255);
+        colors.push_back(((float) command.color.b) / 255);
+        colors.push_back(((float) command.color.a) / 255);
+      }
+    }
+    SDL::glBindTexture(GL_TEXTURE_2D, texture);
     SDL::glEnable(GL_TEXTURE_2D);
     SDL::glEnableClientState(GL_VERTEX_ARRAY);
     SDL::glEnableClientState(GL_TEXTURE_COORD_ARRAY);
@@ -68,17 +135,25 @@ void Renderer::renderDeferredSprites() {
     SDL::glVertexPointer(2, GL_FLOAT, 0, vertices.data());
     SDL::glTexCoordPointer(2, GL_FLOAT, 0, texCoords.data());
     SDL::glDrawArrays(GL_TRIANGLES, 0, vertices.size() / 2);
-    vertices.clear();
-    texCoords.clear();
-    colors.clear();
-
     SDL::glDisableClientState(GL_VERTEX_ARRAY);
     SDL::glDisableClientState(GL_TEXTURE_COORD_ARRAY);
     SDL::glDisableClientState(GL_COLOR_ARRAY);
     SDL::glDisable(GL_TEXTURE_2D);
-    CHECK_OPENGL_ERROR();
   }
-  deferredSprites.clear();
+
+  sth_stash* fontStash;
+  vector<SDL::GLfloat> vertices;
+  vector<SDL::GLfloat> texCoords;
+  vector<SDL::GLfloat> colors;
+};
+}
+
+void Renderer::flushCommands() {
+  if (renderCommands.isEmpty())
+    return;
+  renderCommands.makeBatches();
+  renderBackend->draw(renderCommands);
+  renderCommands.clear();
 }
 
 void Renderer::drawSprite(const Texture& t, Vec2 topLeft, Vec2 bottomRight, Vec2 p, Vec2 k, optional<Color> color) {
@@ -86,11 +161,9 @@ void Renderer::drawSprite(const Texture& t, Vec2 topLeft, Vec2 bottomRight, Vec2
 }
 
 void Renderer::drawSprite(const Texture& t, Vec2 a, Vec2 b, Vec2 c, Vec2 d, Vec2 p, Vec2 k, optional<Color> color) {
-  if (currentTexture && currentTexture != t.getTexId())
-    renderDeferredSprites();
-  currentTexture = t.getTexId();
-  CHECK(currentTexture);
-  deferredSprites.push_back({a, b, c, d, p, k, t.getRealSize(), color});
+  auto texture = t.getTexId();
+  CHECK(texture);
+  renderCommands.addSprite(*texture, t.getRealSize(), a, b, c, d, p, k, color.value_or(Color::WHITE));
 }
 
 static float sizeConv(int size) {
@@ -337,21 +410,60 @@ static optional<int> getMapFontWidth(char32_t c) {
 }
 
 Vec2 Renderer::getTextSize(const string& s, int size, FontId id) {
+  TextWidth width;
+  addText(width, s, size, id);
+  if (id == FontId::MAP_FONT)
+    return Vec2(width.get(), 22);
+  if (s.empty())
+    return Vec2(0, 0);
+  float height;
+  sth_vmetrics(fontStash, getFont(id), sizeConv(size), nullptr, nullptr, &height);
+  return Vec2(width.get(), height);
+}
+
+int Renderer::TextWidth::get() const {
+  return max(maxX, floorf(x)) - minX;
+}
+
+Renderer::GlyphMetrics Renderer::getGlyphMetrics(GlyphTable& table, int font, int size, unsigned int codepoint) {
+  auto load = [&] {
+    GlyphMetrics ret;
+    ret.exists = sth_glyph_metrics(fontStash, font, sizeConv(size), codepoint, &ret.offset, &ret.width, &ret.advance);
+    return ret;
+  };
+  if (codepoint < table.ascii.size()) {
+    auto& ret = table.ascii[codepoint];
+    if (!ret)
+      ret = load();
+    return *ret;
+  }
+  if (auto ret = getValueMaybe(table.other, codepoint))
+    return *ret;
+  return table.other[codepoint] = load();
+}
+
+// Follows sth_dim_text, only the glyph metrics come from a table instead of the font stash.
+void Renderer::addText(TextWidth& width, const string& s, int size, FontId id) {
   if (id == FontId::MAP_FONT) {
-    auto ret = 0;
     for (auto c : s)
-      if (auto width = getMapFontWidth(c))
-        ret += *width - 2;
-    return Vec2(ret, 22);
+      if (auto w = getMapFontWidth(c))
+        width.x += *w - 2;
+    width.maxX = width.x;
+    return;
   }
-  if (s.empty())
-    return Vec2(0, 0);
-  float minx, maxx, miny, maxy;
   int font = getFont(id);
-  sth_dim_text(fontStash, font, sizeConv(size), s.c_str(), &minx, &miny, &maxx, &maxy);
-  float height;
-  sth_vmetrics(fontStash, font, sizeConv(size), nullptr, nullptr, &height);
-  return Vec2(maxx - minx, height);
+  auto& table = glyphTables[make_pair(font, size)];
+  for (unsigned char c : s) {
+    if (sth_decode_utf8(&width.utf8State, &width.codepoint, c))
+      continue;
+    auto glyph = getGlyphMetrics(table, font, size, width.codepoint);
+    if (!glyph.exists)
+      continue;
+    float x0 = floorf(width.x + glyph.offset);
+    width.minX = min(width.minX, x0);
+    width.maxX = max(width.maxX, x0 + glyph.width);
+    width.x += glyph.advance;
+  }
 }
 
 int Renderer::getFont(FontId id) {
@@ -366,7 +478,6 @@ int Renderer::getFont(FontId id) {
 }
 
 void Renderer::drawText(FontId id, int size, Color color, Vec2 pos, const string& s, CenterType center) {
-  renderDeferredSprites();
   if (id == FontId::MAP_FONT) {
     for (int i = 0; i < s.size();) {
       auto res = getUtf8CharAt(s, i);
@@ -396,10 +507,11 @@ void Renderer::drawText(FontId id, int size, Color color, Vec2 pos, const string
       default:
         break;
     }
-    sth_begin_draw(fontStash);
-    glColor(color);
-    sth_draw_text(fontStash, getFont(id), sizeConv(size), ox + pos.x, oy + pos.y + (dim.y * 0.9), s.c_str(), nullptr);
-    sth_end_draw(fontStash);
+    // Glyphs may reach a bit outside of the measured box.
+    Vec2 topLeft = pos + Vec2(ox, oy);
+    auto bounds = Rectangle(topLeft, topLeft + dim).minusMargin(-size);
+    renderCommands.addText(getFont(id), sizeConv(size), RenderPoint{float(ox + pos.x), float(oy + pos.y + (dim.y * 0.9))},
+        color, s, bounds);
   }
 }
 
@@ -472,45 +584,32 @@ void Renderer::drawSprite(Vec2 pos, Vec2 source, Vec2 size, const Texture& t,
 }
 
 void Renderer::drawFilledRectangle(const Rectangle& t, Color color, optional<Color> outline) {
-  renderDeferredSprites();
   Vec2 a = t.topLeft();
   Vec2 b = t.bottomRight();
   if (outline) {
-    SDL::glLineWidth(2);
-    SDL::glBegin(GL_LINE_LOOP);
-    glColor(*outline);
-    SDL::glVertex2f(a.x + 1.5f, a.y + 1.0f);
-    SDL::glVertex2f(b.x - 0.5f, a.y + 1.0f);
-    SDL::glVertex2f(b.x - 0.5f, b.y - 0.5f);
-    SDL::glVertex2f(a.x + 1.5f, b.y - 0.5f);
-    SDL::glEnd();
+    renderCommands.addOutline(RenderPoint{a.x + 1.5f, a.y + 1.0f}, RenderPoint{b.x - 0.5f, a.y + 1.0f},
+        RenderPoint{b.x - 0.5f, b.y - 0.5f}, RenderPoint{a.x + 1.5f, b.y - 0.5f}, *outline);
     a += Vec2(2, 2);
     b -= Vec2(1, 1);
   }
-  SDL::glBegin(GL_QUADS);
-  glColor(color);
-  SDL::glVertex2f(a.x, a.y);
-  SDL::glVertex2f(b.x, a.y);
-  SDL::glVertex2f(b.x, b.y);
-  SDL::glVertex2f(a.x, b.y);
-  SDL::glEnd();
+  renderCommands.addQuad(RenderPoint{float(a.x), float(a.y)}, RenderPoint{float(b.x), float(a.y)},
+      RenderPoint{float(b.x), float(b.y)}, RenderPoint{float(a.x), float(b.y)}, color);
 }
 
 void Renderer::drawLine(Vec2 from, Vec2 to, Color color, double width) {
-  renderDeferredSprites();
-  SDL::glBegin(GL_QUADS);
   double dx = to.x - from.x;
   double dy = to.y - from.y;
   double length = sqrt(dx * dx + dy * dy);
   dx /= length;
   dy /= length;
-  glColor(color);
   width /= 2;
-  SDL::glVertex2d(from.x + dy * width, from.y - dx * width);
-  SDL::glVertex2d(to.x + dy * width, to.y - dx * width);
-  SDL::glVertex2d(to.x - dy * width, to.y + dx * width);
-  SDL::glVertex2d(from.x - dy * width, from.y + dx * width);
-  SDL::glEnd();
+  auto point = [] (double x, double y) { return RenderPoint{float(x), float(y)}; };
+  renderCommands.addQuad(
+      point(from.x + dy * width, from.y - dx * width),
+      point(to.x + dy * width, to.y - dx * width),
+      point(to.x - dy * width, to.y + dx * width),
+      point(from.x - dy * width, from.y + dx * width),
+      color);
 }
 
 void Renderer::drawFilledRectangle(int px, int py, int kx, int ky, Color color, optional<Color> outline) {
@@ -518,11 +617,7 @@ void Renderer::drawFilledRectangle(int px, int py, int kx, int ky, Color color,
 }
 
 void Renderer::drawPoint(Vec2 pos, Color color, int size) {
-  SDL::glPointSize(size);
-  SDL::glBegin(GL_POINTS);
-  glColor(color);
-  SDL::glVertex2f(pos.x, pos.y);
-  SDL::glEnd();
+  renderCommands.addPoint(pos, color, size);
 }
 
 void Renderer::addQuad(const Rectangle& r, Color color) {
@@ -530,12 +625,11 @@ void Renderer::addQuad(const Rectangle& r, Color color) {
 }
 
 void Renderer::setScissor(optional<Rectangle> s, bool reset) {
-  renderDeferredSprites();
   auto applyScissor = [&] (Rectangle rect) {
     double zoom = getZoom();
-    SDL::glScissor(rect.left() * zoom, (getSize().y - rect.bottom()) * zoom,
-        rect.width() * zoom, rect.height() * zoom);
-    SDL::glEnable(GL_SCISSOR_TEST);
+    int x = rect.left() * zoom;
+    int y = (getSize().y - rect.bottom()) * zoom;
+    renderCommands.setScissor(Rectangle(x, y, x + int(rect.width() * zoom), y + int(rect.height() * zoom)));
   };
   if (s) {
     Rectangle rect = *s;
@@ -550,24 +644,16 @@ void Renderer::setScissor(optional<Rectangle> s, bool reset) {
     if (!scissorStack.empty())
       applyScissor(scissorStack.back());
     else
-      SDL::glDisable(GL_SCISSOR_TEST);
+      renderCommands.setScissor(none);
   }
 }
 
 void Renderer::setTopLayer() {
-  renderDeferredSprites();
-  SDL::glPushMatrix();
-  SDL::glTranslated(0, 0, 1);
-  SDL::glDisable(GL_SCISSOR_TEST);
-  CHECK_OPENGL_ERROR();
+  renderCommands.pushLayer();
 }
 
 void Renderer::popLayer() {
-  renderDeferredSprites();
-  SDL::glPopMatrix();
-  if (!scissorStack.empty())
-    SDL::glEnable(GL_SCISSOR_TEST);
-  CHECK_OPENGL_ERROR();
+  renderCommands.popLayer(!scissorStack.empty());
 }
 
 Vec2 Renderer::getSize() {
@@ -714,6 +800,7 @@ Renderer::Renderer(Clock* clock, MySteamInput* i, const string& title, const Dir
   originalCursor = SDL::SDL_GetCursor();
   initOpenGL();
   loadFonts(fontPath, fonts);
+  renderBackend = make_unique<GLRenderBackend>(fontStash);
   auto icon = SDL::IMG_Load(iconPath.getPath());
   SDL_SetWindowIcon(window, icon);
   mapFontTexture.emplace(std::move(*Texture::loadMaybe(mapFontPath))); // work around compiler bug?
@@ -837,7 +924,8 @@ void Renderer::setAnimationsDirectory(const DirectoryPath& path) {
 void Renderer::drawAndClearBuffer() {
   if (steamInput)
     steamInput->runFrame();
-  renderDeferredSprites();
+  flushCommands();
+  renderBackend->endFrame();
   CHECK_OPENGL_ERROR();
   if (fpsLimit) {
     uint64_t end = SDL::SDL_GetPerformanceCounter();
@@ -855,6 +943,7 @@ void Renderer::drawAndClearBuffer() {
 }
 
 void Renderer::resize(int w, int h) {
+  flushCommands();
   SDL_GL_GetDrawableSize(window, &width, &height);
   initOpenGL();
 }
@@ -23,6 +23,7 @@
 #include "color.h"
 #include "texture.h"
 #include "font_id.h"
+#include "render_command_list.h"
 
 class ViewObject;
 class Clock;
@@ -55,6 +56,21 @@ class Renderer {
   static int smallTextSize() { return 14; }
   int getTextLength(const string& s, int size = textSize(), FontId = FontId::TEXT_FONT);
   Vec2 getTextSize(const string& s, int size = textSize(), FontId = FontId::TEXT_FONT);
+  // The width of a text that is measured piece by piece. Adding a piece costs as much as the piece, and gives
+  // the same width as measuring the whole text again.
+  class TextWidth {
+    public:
+    int get() const;
+
+    private:
+    friend class Renderer;
+    float x = 0;
+    float minX = 0;
+    float maxX = 0;
+    unsigned int utf8State = 0;
+    unsigned int codepoint = 0;
+  };
+  void addText(TextWidth&, const string&, int size = textSize(), FontId = FontId::TEXT_FONT);
   enum CenterType { NONE, HOR, VER, HOR_VER };
   void drawText(FontId, int size, Color, Vec2 pos, const string&, CenterType center = NONE);
   void drawTextWithHotkey(Color, Vec2 pos, const string&, char key);
@@ -117,7 +133,8 @@ class Renderer {
   void setAnimationsDirectory(const DirectoryPath&);
   void loadAnimations();
   void makeScreenshot(const FilePath&, Rectangle bounds);
-  void renderDeferredSprites();
+  // Draws everything recorded so far. Needed before drawing with OpenGL directly.
+  void flushCommands();
   MySteamInput* getSteamInput();
   Vec2 getDiscreteJoyPos(ControllerJoy);
 
@@ -150,6 +167,18 @@ class Renderer {
   sth_stash* fontStash;
   void loadFonts(const DirectoryPath& fontPath, FontSet&);
   int getFont(FontId);
+  struct GlyphMetrics {
+    bool exists;
+    float offset;
+    float width;
+    float advance;
+  };
+  struct GlyphTable {
+    std::array<optional<GlyphMetrics>, 128> ascii;
+    HashMap<unsigned int, GlyphMetrics> other;
+  };
+  HashMap<pair<int, int>, GlyphTable> glyphTables;
+  GlyphMetrics getGlyphMetrics(GlyphTable&, int font, int size, unsigned int codepoint);
   optional<thread::id> renderThreadId;
   bool fullscreen;
   int fullscreenMode;
@@ -164,16 +193,10 @@ class Renderer {
   SDL::SDL_Cursor* cursor;
   SDL::SDL_Cursor* cursorClicked;
   SDL::SDL_Surface* loadScaledSurface(const FilePath& path, double scale);
-  optional<SDL::GLuint> currentTexture;
   void drawSprite(const Texture& t, Vec2 a, Vec2 b, Vec2 c, Vec2 d, Vec2 p, Vec2 k, optional<Color> color);
   void drawSprite(const Texture& t, Vec2 topLeft, Vec2 bottomRight, Vec2 p, Vec2 k, optional<Color> color);
-  struct DeferredSprite {
-    Vec2 a, b, c, d;
-    Vec2 p, k;
-    Vec2 realSize;
-    optional<Color> color;
-  };
-  vector<DeferredSprite> deferredSprites;
+  RenderCommandList renderCommands;
+  unique_ptr<RenderBackend> renderBackend;
   vector<Rectangle> scissorStack;
   void loadTilesFromDir(const DirectoryPath&, Vec2 size, int setWidth);
   struct TileDirectory {
@@ -7,3 +7,5 @@ class CollectiveResourceId : public ContentId<CollectiveResourceId> {
   public:
   using ContentId::ContentId;
 };
+
+CEREAL_CLASS_VERSION(CollectiveResourceId, 1)
@@ -0,0 +1,74 @@
+#include "stdafx.h"
+#include "serial_dictionary.h"
+#include "debug.h"
+
+void saveVarInt(cereal::BinaryOutputArchive& ar, std::uint32_t value) {
+  while (value >= 0x80) {
+    std::uint8_t byte = (value & 0x7f) | 0x80;
+    ar(byte);
+    value >>= 7;
+  }
+  std::uint8_t byte = value;
+  ar(byte);
+}
+
+std::uint32_t loadVarInt(cereal::BinaryInputArchive& ar) {
+  std::uint32_t ret = 0;
+  for (int shift = 0; shift < 32; shift += 7) {
+    std::uint8_t byte;
+    ar(byte);
+    ret |= std::uint32_t(byte & 0x7f) << shift;
+    if (!(byte & 0x80))
+      return ret;
+  }
+  throw ::cereal::Exception("Malformed variable length integer");
+}
+
+static thread_local SerialDictionary* currentDictionary = nullptr;
+
+SerialDictionary::SerialDictionary(const void* archive) : archive(archive), previous(currentDictionary) {
+  currentDictionary = this;
+}
+
+SerialDictionary::~SerialDictionary() {
+  CHECK(currentDictionary == this);
+  currentDictionary = previous;
+}
+
+SerialDictionary* SerialDictionary::get(const void* archive) {
+  for (auto ret = currentDictionary; ret; ret = ret->previous)
+    if (ret->archive == archive)
+      return ret;
+  return nullptr;
+}
+
+int SerialDictionary::getNewTable() {
+  static atomic<int> numTables(0);
+  return numTables++;
+}
+
+optional<int> SerialDictionary::addOutput(int table, int key) {
+  if (table >= outputIndexes.size()) {
+    outputIndexes.resize(table + 1);
+    outputCounts.resize(table + 1, 0);
+  }
+  auto& indexes = outputIndexes[table];
+  if (key >= indexes.size())
+    indexes.resize(key + 1, -1);
+  if (indexes[key] >= 0)
+    return indexes[key];
+  indexes[key] = outputCounts[table]++;
+  return none;
+}
+
+void SerialDictionary::addInput(int table, int key) {
+  if (table >= inputKeys.size())
+    inputKeys.resize(table + 1);
+  inputKeys[table].push_back(key);
+}
+
+optional<int> SerialDictionary::getInput(int table, int index) const {
+  if (table < inputKeys.size() && index >= 0 && index < inputKeys[table].size())
+    return inputKeys[table][index];
+  return none;
+}
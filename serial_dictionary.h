@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cereal/archives/binary.hpp>
+#include "stdafx.h"
+#include "extern/optional.h"
+
+void saveVarInt(cereal::BinaryOutputArchive&, std::uint32_t);
+std::uint32_t loadVarInt(cereal::BinaryInputArchive&);
+
+// Lets binary archives write a repeated id (such as a content id string) only once and refer
+// to it by a small index afterwards. A dictionary is bound to a single archive for its lifetime.
+class SerialDictionary {
+  public:
+  explicit SerialDictionary(const void* archive);
+  ~SerialDictionary();
+  SerialDictionary(const SerialDictionary&) = delete;
+  void operator = (const SerialDictionary&) = delete;
+
+  static SerialDictionary* get(const void* archive);
+  static int getNewTable();
+
+  // Returns the index of the key if it was already written, otherwise registers it.
+  optional<int> addOutput(int table, int key);
+  void addInput(int table, int key);
+  optional<int> getInput(int table, int index) const;
+
+  private:
+  const void* archive;
+  SerialDictionary* previous;
+  std::vector<std::vector<int>> outputIndexes;
+  std::vector<int> outputCounts;
+  std::vector<std::vector<int>> inputKeys;
+};
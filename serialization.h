@@ -37,9 +37,11 @@
 #include "extern/variant_serialize.h"
 #include "serialize_optional.h"
 #include "mem_usage_counter.h"
+#include "flat_hash.h"
 
 #include "stdafx.h"
 #include "progress.h"
+#include "serial_dictionary.h"
 
 typedef cereal::BinaryInputArchive InputArchive;
 typedef cereal::BinaryOutputArchive OutputArchive;
@@ -139,7 +141,7 @@ template <class T, class U>
 class StreamCombiner {
   public:
   template <typename ...Args>
-  StreamCombiner(Args... args) : stream(args...), archive(stream) {
+  StreamCombiner(Args... args) : stream(args...), archive(stream), dictionary(&archive) {
  //   CHECK(stream.good()) << "File not found: " << filename;
   }
 
@@ -154,6 +156,7 @@ class StreamCombiner {
   private:
   T stream;
   U archive;
+  SerialDictionary dictionary;
 };
 
 namespace cereal {
@@ -178,6 +181,18 @@ void load(Archive& ar1, optional<T>& elem) {
   } else
     elem = none;
   }
+
+// Saved the same way as std::unordered_set, so that switching between the two keeps saves compatible.
+// FlatHashMap is handled by cereal's generic map functions.
+template <class Archive, class K, class H>
+void save(Archive& ar1, const FlatHashSet<K, H>& set) {
+  unordered_set_detail::save(ar1, set);
+}
+
+template <class Archive, class K, class H>
+void load(Archive& ar1, FlatHashSet<K, H>& set) {
+  unordered_set_detail::load(ar1, set);
+}
 } // namespace cereal
 
 template <typename T>
@@ -53,8 +53,9 @@ class DistanceTable {
   int counter = 1;
 };
 
-static DistanceTable distanceTable(Level::getMaxBounds());
-static DirtyTable<double> navigationCostCache(Level::getMaxBounds(), 0);
+// Per thread, because layouts are generated on worker threads when LevelMaker::setParallelGeneration is on.
+static thread_local DistanceTable distanceTable(Level::getMaxBounds());
+static thread_local DirtyTable<double> navigationCostCache(Level::getMaxBounds(), 0);
 
 template <typename Fun>
 static auto getCached(Fun fun) {
@@ -127,7 +128,7 @@ void ShortestPath::init(EntryFun entryFun, LengthFun lengthFun, DirectionsFun di
     double posDist = distanceTable.getDistance(pos);
    // INFO << "Popping " << pos << " " << distance[pos]  << " " << (from ? (*from - pos).length4() : 0);
     if (from == pos || (limit && distanceTable.getDistance(pos) >= *limit)) {
-      INFO << "Shortest path from " << (from ? *from : Vec2(-1, -1)) << " to " << target << " " << numPopped
+      INFO_VERBOSE << "Shortest path from " << (from ? *from : Vec2(-1, -1)) << " to " << target << " " << numPopped
         << " visited distance " << distanceTable.getDistance(pos);
       constructPath(pos, directions);
       return;
@@ -153,7 +154,7 @@ void ShortestPath::init(EntryFun entryFun, LengthFun lengthFun, DirectionsFun di
       }
     }
   }
-  INFO << "Shortest path exhausted, " << numPopped << " visited";
+  INFO_VERBOSE << "Shortest path exhausted, " << numPopped << " visited";
 }
 
 void ShortestPath::reverse(function<double(Vec2)> entryFun, function<double(Vec2)> lengthFun, function<vector<Vec2>(Vec2)> directions,
@@ -174,7 +175,7 @@ void ShortestPath::reverse(function<double(Vec2)> entryFun, function<double(Vec2
     ++numPopped;
     Vec2 pos = q.top().pos;
     if (from == pos) {
-      INFO << "Rev shortest path from " << " from " << target << " " << numPopped << " visited";
+      INFO_VERBOSE << "Rev shortest path from " << " from " << target << " " << numPopped << " visited";
       constructPath(pos, directions, true);
       return;
     }
@@ -188,7 +189,7 @@ void ShortestPath::reverse(function<double(Vec2)> entryFun, function<double(Vec2
         }
       }
   }
-  INFO << "Rev shortest path from " << " from " << target << " " << numPopped << " visited";
+  INFO_VERBOSE << "Rev shortest path from " << " from " << target << " " << numPopped << " visited";
 }
 
 void ShortestPath::constructPath(Vec2 pos, function<vector<Vec2>(Vec2)> directions, bool reversed) {
@@ -258,15 +259,18 @@ ShortestPath LevelShortestPath::makeShortestPath(Position from, MovementType mov
   Level* level = from.getLevel();
   Rectangle bounds = level->getBounds();
   CHECK(to.isSameLevel(from));
-  auto& sectors = level->getSectors(movementType);
-  auto& movementSectors = level->getSectors(copyOf(movementType).setCanBuildBridge(false).setDestroyActions({}));
-  auto entryFun = [=, &sectors, &movementSectors, fromCoord = from.getCoord()](Vec2 v) {
+  auto& navigationCosts = level->getNavigationCosts(movementType);
+  auto entryFun = [=, &navigationCosts, fromCoord = from.getCoord()](Vec2 v) {
     PROFILE_BLOCK("entry fun");
     if (fromCoord == v)
       return 1.0;
-    if (!sectors.contains(v))
-      return ShortestPath::infinity;
-    return Position(v, level, Position::IsValid{}).getNavigationCost(movementType, movementSectors);
+    auto cost = navigationCosts[v];
+    if (cost > 0)
+      return double(cost);
+    Position pos(v, level, Position::IsValid{});
+    if (cost < 0)
+      return pos.getDestroyOrBridgeCost(movementType);
+    return pos.getCreature() ? 5.0 : 1.0;
   };
   auto directionsFun = [=] (Vec2 v) {
     Position pos(v, level);
@@ -56,6 +56,11 @@ const vector<Vec2>& Spectator::getUnknownLocations(const Level*) const {
   return empty;
 }
 
+EventSubscription Spectator::getEventSubscription() {
+  using namespace EventInfo;
+  return {getEventMask<Projectile, FX>()};
+}
+
 void Spectator::onEvent(const GameEvent& event) {
   using namespace EventInfo;
   event.visit<void>(
@@ -9,6 +9,7 @@ class Spectator : public OwnedObject<Spectator>, public CreatureView, public Eve
   public:
   Spectator(Level*, View*);
   void onEvent(const GameEvent&);
+  static EventSubscription getEventSubscription();
   virtual const MapMemory& getMemory() const override;
   virtual void getViewIndex(Vec2 pos, ViewIndex&) const override;
   virtual void refreshGameInfo(GameInfo&) const override;
@@ -6,3 +6,5 @@ class SpellId : public ContentId<SpellId> {
   public:
   using ContentId::ContentId;
 };
+
+CEREAL_CLASS_VERSION(SpellId, 1)
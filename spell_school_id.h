@@ -6,3 +6,5 @@ class SpellSchoolId : public ContentId<SpellSchoolId> {
   public:
   using ContentId::ContentId;
 };
+
+CEREAL_CLASS_VERSION(SpellSchoolId, 1)
@@ -14,7 +14,15 @@ int printStacktraceWithGdb() {
   return system(gdbcmd);
 }
 
+static void (*crashHook)() = nullptr;
+
+void setCrashHook(void (*hook)()) {
+  crashHook = hook;
+}
+
 void miniDumpFunction(unsigned int nExceptionCode, EXCEPTION_POINTERS *pException) {
+  if (crashHook)
+    crashHook();
   HANDLE hFile = CreateFileA("KeeperRL.dmp", GENERIC_READ | GENERIC_WRITE,
     0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
   if ((hFile != NULL) && (hFile != INVALID_HANDLE_VALUE)) {
@@ -77,9 +85,30 @@ extern "C"
 }
 
 #else
+
+#include <csignal>
+
+static void (*crashHook)() = nullptr;
+
+void setCrashHook(void (*hook)()) {
+  crashHook = hook;
+}
+
+static void onCrashSignal(int sig) {
+  signal(sig, SIG_DFL);
+  if (crashHook)
+    crashHook();
+  raise(sig);
+}
+
 void attachConsole() {
 }
 void initializeMiniDump() {
+  signal(SIGSEGV, onCrashSignal);
+  signal(SIGABRT, onCrashSignal);
+  signal(SIGFPE, onCrashSignal);
+  signal(SIGILL, onCrashSignal);
+  signal(SIGBUS, onCrashSignal);
 }
 void setConsoleColor(int) {
 }
@@ -1,6 +1,8 @@
 #pragma once
 
 void initializeMiniDump();
+// Called before the program goes down because of a crash.
+void setCrashHook(void (*)());
 void attachConsole();
 void setConsoleColor(int);
 void dpiAwareness();
\ No newline at end of file
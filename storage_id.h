@@ -7,3 +7,5 @@ class StorageId : public ContentId<StorageId> {
   public:
   using ContentId::ContentId;
 };
+
+CEREAL_CLASS_VERSION(StorageId, 1)
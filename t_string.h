@@ -88,3 +88,5 @@ TString makePlural(TString);
 TString setSubjectGender(TString sentence, TString subject);
 TString toPercentage(double);
 TString toStringWithSign(int);
+
+CEREAL_CLASS_VERSION(TStringId, 1)
@@ -50,7 +50,9 @@ class TaskMap {
   EntityMap<Creature, Task*> SERIAL(taskByCreature);
   EntityMap<Task, Creature*> SERIAL(creatureByTask);
   EntityMap<Task, Position> SERIAL(positionMap);
-  HashMap<Position, vector<Task*>> SERIAL(reversePositions);
+  // Looked up for every rendered square. Nothing holds on to an entry while tasks are added, so the faster
+  // open addressing map is safe here.
+  FlatHashMap<Position, vector<Task*>, CustomHash<Position>> SERIAL(reversePositions);
   vector<PTask> SERIAL(tasks);
   EntityMap<Task, Task*> SERIAL(taskById);
   HashMap<Position, Task*> SERIAL(marked);
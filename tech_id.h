@@ -6,3 +6,5 @@ class TechId : public ContentId<TechId> {
   public:
   using ContentId::ContentId;
 };
+
+CEREAL_CLASS_VERSION(TechId, 1)
@@ -4,7 +4,17 @@
 #include "movement_type.h"
 #include "position_map.h"
 
-SERIALIZE_DEF(Territory, allSquares, allSquaresVec, centralPoint)
+template <class Archive>
+void Territory::serialize(Archive& ar, const unsigned int version) {
+  if (Archive::is_loading::value && version == 0) {
+    PositionSet oldSquares;
+    ar(oldSquares, allSquaresVec, centralPoint);
+    allSquares = DensePositionSet(oldSquares);
+  } else
+    ar(allSquares, allSquaresVec, centralPoint);
+}
+
+SERIALIZABLE(Territory)
 
 void Territory::clearCache() {
   extendedCache.clear();
@@ -12,9 +22,8 @@ void Territory::clearCache() {
 }
 
 void Territory::insert(Position pos) {
-  if (!allSquares.count(pos)) {
+  if (allSquares.insert(pos)) {
     allSquaresVec.push_back(pos);
-    allSquares.insert(pos);
     clearCache();
   }
 }
@@ -37,7 +46,7 @@ const vector<Position>& Territory::getAll() const {
   return allSquaresVec;
 }
 
-const PositionSet& Territory::getAllAsSet() const {
+const DensePositionSet& Territory::getAllAsSet() const {
   return allSquares;
 }
 
@@ -2,6 +2,7 @@
 
 #include "util.h"
 #include "position.h"
+#include "dense_position_set.h"
 
 class Territory {
   public:
@@ -11,7 +12,7 @@ class Territory {
 
   bool contains(Position) const;
   const vector<Position>& getAll() const;
-  const PositionSet& getAllAsSet() const;
+  const DensePositionSet& getAllAsSet() const;
   const vector<Position>& getExtended(int min, int max) const;
   const vector<Position>& getExtended(int max) const;
   const vector<Position>& getStandardExtended() const;
@@ -26,11 +27,11 @@ class Territory {
   private:
   void clearCache();
   vector<Position> calculateExtended(int minRadius, int maxRadius) const;
-  PositionSet SERIAL(allSquares);
+  DensePositionSet SERIAL(allSquares);
   vector<Position> SERIAL(allSquaresVec);
   optional<Position> SERIAL(centralPoint);
   mutable map<pair<int, int>, vector<Position>> extendedCache;
   mutable map<int, vector<Position>> extendedCache2;
 };
 
-
+CEREAL_CLASS_VERSION(Territory, 1)
@@ -48,6 +48,12 @@
 #include "biome_id.h"
 #include "item_types.h"
 #include "creature_attributes.h"
+#include "clock.h"
+#include "furniture_type.h"
+#include "layout_canvas.h"
+#include "frame_arena.h"
+#include "render_command_list.h"
+#include "light_engine.h"
 
 class Test {
   public:
@@ -799,6 +805,82 @@ class Test {
     CHECK(equipment.getItemsOwnedBy(human.get()).size() == items.size());
   }
 
+  // Every other creature gets a lasting effect, every third a permanent one and every fifth an expired one.
+  static vector<PCreature> getCreaturesWithEffects(int count, GlobalTime time) {
+    vector<PCreature> creatures;
+    for (int i : Range(count))
+      creatures.push_back(CreatureFactory::getHumanForTests());
+    for (int i : All(creatures)) {
+      auto& attributes = creatures[i]->getAttributes();
+      if (i % 2 == 0)
+        attributes.addLastingEffect(LastingEffect::SLEEP, time + 10_visible);
+      if (i % 3 == 0)
+        attributes.addPermanentEffect(LastingEffect::POISON_RESISTANT, 1);
+      if (i % 5 == 0)
+        attributes.addLastingEffect(LastingEffect::POISON, time - 10_visible);
+    }
+    return creatures;
+  }
+
+  // The per-turn effect passes of Creature::tick, scanning every effect and using the active effect lists.
+  static int countEffectsScanningAll(const Creature* c, GlobalTime time, const ContentFactory* factory) {
+    auto& attributes = c->getAttributes();
+    auto& body = c->getBody();
+    int ret = 0;
+    for (auto effect : ENUM_ALL(LastingEffect))
+      ret += attributes.isAffected(effect, time) + body.isIntrinsicallyAffected(effect, factory);
+    for (auto& buff : factory->buffs)
+      ret += body.isIntrinsicallyAffected(buff.first, factory);
+    return ret;
+  }
+
+  static int countActiveEffects(const Creature* c, GlobalTime time, const ContentFactory* factory) {
+    auto& attributes = c->getAttributes();
+    int ret = c->getBody().getIntrinsicEffects(factory).size();
+    for (auto effect : attributes.getActiveEffects())
+      ret += attributes.isAffected(effect, time);
+    return ret;
+  }
+
+  void testActiveEffects() {
+    auto contentFactory = getContentFactory();
+    const auto time = GlobalTime(100);
+    auto creatures = getCreaturesWithEffects(30, time);
+    for (auto& c : creatures) {
+      auto& attributes = c->getAttributes();
+      for (auto effect : ENUM_ALL(LastingEffect))
+        if (attributes.isAffected(effect, time))
+          CHECK(attributes.getActiveEffects().contains(effect));
+      CHECKEQ(countEffectsScanningAll(c.get(), time, &contentFactory),
+          countActiveEffects(c.get(), time, &contentFactory));
+    }
+    auto& attributes = creatures[0]->getAttributes();
+    CHECKEQ(attributes.getActiveEffects().size(), 3);
+    attributes.clearLastingEffect(LastingEffect::POISON);
+    attributes.removePermanentEffect(LastingEffect::POISON_RESISTANT, 1);
+    CHECK(attributes.getActiveEffects() == vector<LastingEffect>{LastingEffect::SLEEP});
+  }
+
+  void benchmarkActiveEffects() {
+    auto contentFactory = getContentFactory();
+    const auto time = GlobalTime(100);
+    auto creatures = getCreaturesWithEffects(500, time);
+    const int numTurns = 100;
+    auto measure = [&](auto fun) {
+      auto start = Clock::getRealMicros().count();
+      int numAffected = 0;
+      for (int turn : Range(numTurns))
+        for (auto& c : creatures)
+          numAffected += fun(c.get(), time, &contentFactory);
+      return make_pair(Clock::getRealMicros().count() - start, numAffected);
+    };
+    auto scanAll = measure(countEffectsScanningAll);
+    auto activeOnly = measure(countActiveEffects);
+    CHECKEQ(scanAll.second, activeOnly.second);
+    INFO << "Effect passes for " << creatures.size() << " creatures: " << scanAll.first / numTurns
+        << "us per turn scanning all effects, " << activeOnly.first / numTurns << "us per turn with active effect lists";
+  }
+
   void testContainerRange() {
     vector<string> v { "abc", "def", "ghi" };
     int i = 0;
@@ -913,6 +995,159 @@ class Test {
     CHECKEQ(cache.getSize(), 3);
   }
 
+  void testFlatHashContainers() {
+    RandomGen random;
+    random.init(123);
+    std::unordered_map<int, int> reference;
+    FlatHashMap<int, int> map;
+    for (int i : Range(20000)) {
+      int key = random.get(2000);
+      switch (random.get(4)) {
+        case 0:
+          reference[key] = i;
+          map[key] = i;
+          break;
+        case 1:
+          CHECKEQ(reference.erase(key), map.erase(key));
+          break;
+        case 2:
+          CHECKEQ(reference.insert(make_pair(key, i)).second, map.insert(make_pair(key, i)).second);
+          break;
+        case 3:
+          CHECKEQ(reference.count(key), map.count(key));
+          break;
+      }
+      CHECKEQ(reference.size(), map.size());
+    }
+    for (auto& elem : reference)
+      CHECKEQ(map.at(elem.first), elem.second);
+    auto copy = map;
+    CHECK(copy == map);
+    for (auto it = copy.begin(); it != copy.end();)
+      if (it->first % 2)
+        it = copy.erase(it);
+      else
+        ++it;
+    for (auto& elem : reference)
+      CHECKEQ(copy.count(elem.first), elem.first % 2 ? 0 : 1);
+    // Saves have to stay loadable when switching between the std and the flat containers.
+    unordered_map<Vec2, string, CustomHash<Vec2>> stdMap {{Vec2(1, 2), "a"}, {Vec2(-3, 4), "b"}};
+    unordered_set<Vec2, CustomHash<Vec2>> stdSet {Vec2(5, 6), Vec2(0, 0)};
+    std::stringstream stream;
+    {
+      OutputArchive archive(stream);
+      archive(stdMap, stdSet);
+    }
+    FlatHashMap<Vec2, string, CustomHash<Vec2>> flatMap;
+    FlatHashSet<Vec2, CustomHash<Vec2>> flatSet;
+    {
+      InputArchive archive(stream);
+      archive(flatMap, flatSet);
+    }
+    CHECKEQ(flatMap.size(), 2);
+    CHECKEQ(flatMap[Vec2(-3, 4)], "b");
+    CHECK(flatSet.count(Vec2(5, 6)) && flatSet.count(Vec2(0, 0)) && flatSet.size() == 2);
+    std::stringstream stream2;
+    {
+      OutputArchive archive(stream2);
+      archive(flatMap, flatSet);
+    }
+    decltype(stdMap) stdMap2;
+    decltype(stdSet) stdSet2;
+    {
+      InputArchive archive(stream2);
+      archive(stdMap2, stdSet2);
+    }
+    CHECK(stdMap2 == stdMap && stdSet2 == stdSet);
+  }
+
+  // The workloads of the hot hash containers: a Dijkstra search over a map of distances, reverse position
+  // lookups of tasks, and saving and loading a big map.
+  template <template <typename...> class Map, template <typename...> class Set>
+  vector<long long> measureHashWorkloads() {
+    vector<long long> ret;
+    auto measure = [&ret](auto fun) {
+      auto start = Clock::getRealMicros().count();
+      fun();
+      ret.push_back(Clock::getRealMicros().count() - start);
+    };
+    measure([] {
+      Rectangle bounds(200, 200);
+      for (int i : Range(5)) {
+        Map<Vec2, double, CustomHash<Vec2>> distance;
+        Set<Vec2, CustomHash<Vec2>> done;
+        priority_queue<pair<double, Vec2>, vector<pair<double, Vec2>>, std::greater<pair<double, Vec2>>> q;
+        distance[Vec2(i, i)] = 0;
+        q.push(make_pair(0.0, Vec2(i, i)));
+        while (!q.empty()) {
+          auto pos = q.top().second;
+          q.pop();
+          if (!done.insert(pos).second)
+            continue;
+          for (auto dir : Vec2::directions8()) {
+            auto next = pos + dir;
+            if (next.inRectangle(bounds) && (next.x * 7 + next.y * 3) % 11) {
+              double dist = distance[pos] + dir.lengthD();
+              auto it = distance.find(next);
+              if (it == distance.end() || it->second > dist) {
+                distance[next] = dist;
+                q.push(make_pair(dist, next));
+              }
+            }
+          }
+        }
+        CHECK(distance.size() > 30000);
+      }
+    });
+    measure([] {
+      RandomGen random;
+      random.init(1);
+      Map<Vec2, vector<int>, CustomHash<Vec2>> reversePositions;
+      for (int i : Range(20000))
+        reversePositions[Vec2(random.get(300), random.get(300))].push_back(i);
+      int found = 0;
+      for (int i : Range(1000000))
+        if (reversePositions.count(Vec2(random.get(300), random.get(300))))
+          ++found;
+      for (int i : Range(10000))
+        reversePositions.erase(Vec2(random.get(300), random.get(300)));
+      CHECK(found > 0);
+    });
+    measure([] {
+      Map<Vec2, int, CustomHash<Vec2>> map;
+      for (Vec2 v : Rectangle(300, 300))
+        map[v] = v.x * v.y;
+      for (int i : Range(5)) {
+        std::stringstream stream;
+        {
+          OutputArchive archive(stream);
+          archive(map);
+        }
+        decltype(map) loaded;
+        {
+          InputArchive archive(stream);
+          archive(loaded);
+        }
+        CHECKEQ(loaded.size(), map.size());
+      }
+    });
+    return ret;
+  }
+
+  template <typename Key, typename Value, typename Hash>
+  using StdHashMap = unordered_map<Key, Value, Hash>;
+
+  template <typename Key, typename Hash>
+  using StdHashSet = unordered_set<Key, Hash>;
+
+  void benchmarkHashContainers() {
+    auto stdTimes = measureHashWorkloads<StdHashMap, StdHashSet>();
+    auto flatTimes = measureHashWorkloads<FlatHashMap, FlatHashSet>();
+    vector<string> names {"pathfinding", "task lookup", "save and load"};
+    for (int i : All(names))
+      INFO << "Hash containers, " << names[i] << ": " << stdTimes[i] << "us std, " << flatTimes[i] << "us flat";
+  }
+
   struct Tmp123 {
     int SERIAL(a);
     char SERIAL(a1);
@@ -945,6 +1180,223 @@ class Test {
     SERIALIZE_ALL(a, b, c, d, e)
   };
 
+  // Saves from before Table<bool> was packed to bits.
+  struct OldBoolTable {
+    const Table<bool>& table;
+    template <class Archive>
+    void save(Archive& ar, const unsigned int) const {
+      ar << table.getBounds();
+      for (Vec2 v : table.getBounds())
+        ar << table[v];
+    }
+  };
+
+  void testTableSerialization() {
+    Table<bool> bools(Rectangle(-3, 5, 97, 68));
+    Table<short> shorts(Rectangle(10, 10));
+    Table<string> strings(Rectangle(3, 3));
+    for (Vec2 v : bools.getBounds())
+      bools[v] = (v.x * 7 + v.y * 3) % 5 == 0;
+    for (Vec2 v : shorts.getBounds())
+      shorts[v] = v.x * 100 - v.y;
+    for (Vec2 v : strings.getBounds())
+      strings[v] = toString(v);
+    std::stringstream stream;
+    {
+      OutputArchive archive(stream);
+      archive(bools, shorts, strings);
+    }
+    CHECK(stream.str().size() < 2000) << stream.str().size();
+    Table<bool> bools2(0, 0);
+    Table<short> shorts2(0, 0);
+    Table<string> strings2(0, 0);
+    {
+      InputArchive archive(stream);
+      archive(bools2, shorts2, strings2);
+    }
+    CHECK(bools2.getBounds() == bools.getBounds() && shorts2.getBounds() == shorts.getBounds());
+    for (Vec2 v : bools.getBounds())
+      CHECKEQ(bools2[v], bools[v]);
+    for (Vec2 v : shorts.getBounds())
+      CHECKEQ(shorts2[v], shorts[v]);
+    for (Vec2 v : strings.getBounds())
+      CHECKEQ(strings2[v], strings[v]);
+    OldBoolTable old {bools};
+    std::stringstream oldStream;
+    {
+      OutputArchive archive(oldStream);
+      archive(old);
+    }
+    Table<bool> bools3(0, 0);
+    {
+      InputArchive archive(oldStream);
+      archive(bools3);
+    }
+    for (Vec2 v : bools.getBounds())
+      CHECKEQ(bools3[v], bools[v]);
+  }
+
+  void testLayoutTile() {
+    vector<LayoutToken> tokens;
+    for (int i : Range(70))
+      tokens.push_back(LayoutToken("test_token" + toString(i)));
+    CHECK(LayoutToken("test_token3") == tokens[3]);
+    CHECKEQ(tokens[3].data(), "test_token3");
+    LayoutTile tile;
+    vector<LayoutToken> expected;
+    auto checkTile = [&] {
+      CHECKEQ(tile.size(), expected.size());
+      for (int i : All(expected))
+        CHECK(tile.begin()[i] == expected[i]);
+      for (auto token : tokens)
+        CHECKEQ(tile.contains(token), expected.contains(token));
+    };
+    // Tokens 0 and 64 share a bit of the mask.
+    for (int i : {0, 64, 5, 64, 7, 8, 9, 10, 11})
+      if (!expected.contains(tokens[i])) {
+        tile.add(tokens[i]);
+        expected.push_back(tokens[i]);
+        checkTile();
+      }
+    tile.addFront(tokens[20]);
+    expected.push_front(tokens[20]);
+    checkTile();
+    for (int i : {64, 9, 3, 20, 0})
+      if (expected.removeElementMaybePreserveOrder(tokens[i])) {
+        tile.remove(tokens[i]);
+        checkTile();
+      }
+    auto copy = tile;
+    tile.clear();
+    CHECK(tile.empty());
+    tile = copy;
+    checkTile();
+  }
+
+  void testFrameArena() {
+    FrameArena arena;
+    auto make = [&] (int value) {
+      return std::allocate_shared<pair<int, string>>(FrameAllocator<pair<int, string>>(&arena), value, "frame");
+    };
+    vector<shared_ptr<pair<int, string>>> frame;
+    for (int i : Range(5000))
+      frame.push_back(make(i));
+    for (int i : All(frame))
+      CHECKEQ(frame[i]->first, i);
+    auto stats = arena.getStats();
+    CHECKEQ(stats.numAllocations, 5000);
+    CHECK(stats.numChunks > 1);
+    int numChunks = stats.numChunks;
+    auto survivor = frame[4000];
+    frame.clear();
+    arena.startFrame();
+    CHECKEQ(arena.getStats().numPinnedChunks, 1);
+    for (int i : Range(5000))
+      frame.push_back(make(i));
+    CHECKEQ(survivor->first, 4000);
+    CHECK(arena.getStats().numChunks <= numChunks + 1);
+    auto big = std::allocate_shared<std::array<char, 100000>>(FrameAllocator<std::array<char, 100000>>(&arena));
+    big->fill('x');
+    {
+      FrameArena::Scope scope(&arena);
+      CHECK(FrameArena::getCurrent() == &arena);
+      {
+        FrameArena::Scope scope(nullptr);
+        CHECK(!FrameArena::getCurrent());
+      }
+      CHECK(FrameArena::getCurrent() == &arena);
+    }
+    CHECK(!FrameArena::getCurrent());
+  }
+
+  void testLightEngine() {
+    Rectangle bounds(20, 20);
+    Table<bool> walls(bounds, false);
+    vector<SVec2> visible;
+    auto visibleTiles = [&] (Vec2 pos) -> const vector<SVec2>& {
+      visible.clear();
+      for (Vec2 v : Rectangle::centered(pos, 8).intersection(bounds))
+        if (!walls[v])
+          visible.push_back(SVec2{short(v.x), short(v.y)});
+      return visible;
+    };
+    LightEngine engine(bounds);
+    engine.addSource(Vec2(5, 5), 6, false, 2, visibleTiles);
+    engine.addSource(Vec2(12, 12), 4, true, 1, visibleTiles);
+    CHECK(engine.getLight(Vec2(6, 5)) > 0);
+    CHECK(engine.getLightCap(Vec2(12, 12)) < 1);
+    walls[Vec2(7, 5)] = true;
+    engine.squareChanged(Vec2(7, 5), visibleTiles);
+    CHECKEQ(engine.getLight(Vec2(7, 5)), 0.0);
+    std::stringstream stream;
+    {
+      OutputArchive archive(stream);
+      archive(engine);
+    }
+    LightEngine loaded(Rectangle(0, 0));
+    {
+      InputArchive archive(stream);
+      archive(loaded);
+    }
+    loaded.recompute(visibleTiles);
+    for (Vec2 v : bounds) {
+      CHECKEQ(loaded.getLight(v), engine.getLight(v));
+      CHECKEQ(loaded.getLightCap(v), engine.getLightCap(v));
+    }
+    // Removing more copies than were added, or a source that was never added, doesn't go below zero.
+    loaded.addSource(Vec2(5, 5), 6, false, -3, visibleTiles);
+    loaded.addSource(Vec2(15, 3), 6, false, -1, visibleTiles);
+    loaded.addSource(Vec2(12, 12), 4, true, -1, visibleTiles);
+    for (Vec2 v : bounds) {
+      CHECKEQ(loaded.getLight(v), 0.0);
+      CHECKEQ(loaded.getLightCap(v), 1.0);
+    }
+  }
+
+  void testRenderCommandBatching() {
+    RenderCommandList list;
+    RecordingRenderBackend backend(Vec2(1000, 1000));
+    auto sprite = [&] (unsigned int texture, Vec2 pos) {
+      list.addSprite(texture, Vec2(64, 64), pos, pos + Vec2(24, 0), pos + Vec2(24, 24), pos + Vec2(0, 24),
+          Vec2(0, 0), Vec2(24, 24), Color::WHITE);
+    };
+    auto draw = [&] {
+      list.makeBatches();
+      backend.draw(list);
+      backend.endFrame();
+      vector<vector<int>> ret;
+      for (auto& batch : list.getBatches()) {
+        ret.emplace_back();
+        for (int i : Range(batch.begin, batch.end))
+          ret.back().push_back(list.getOrder()[i]);
+      }
+      list.clear();
+      return ret;
+    };
+    // A row of tiles alternating between two textures.
+    for (int i : Range(10))
+      sprite(i % 2 + 1, Vec2(i * 24, 0));
+    CHECKEQ(draw(), vector<vector<int>>({{0, 2, 4, 6, 8}, {1, 3, 5, 7, 9}}));
+    CHECKEQ(backend.getFrames().back().numBatches, 2);
+    CHECKEQ(backend.getFrames().back().numUnmergedBatches, 10);
+    // A sprite can't be moved under something that it's drawn over.
+    sprite(1, Vec2(0, 0));
+    sprite(2, Vec2(10, 10));
+    sprite(1, Vec2(20, 20));
+    list.addQuad({100, 100}, {200, 100}, {200, 200}, {100, 200}, Color::BLACK);
+    sprite(2, Vec2(300, 300));
+    CHECKEQ(draw(), vector<vector<int>>({{0}, {1, 4}, {2}, {3}}));
+    // Nor across a scissor.
+    sprite(1, Vec2(0, 0));
+    list.setScissor(Rectangle(0, 0, 500, 500));
+    sprite(2, Vec2(100, 0));
+    sprite(1, Vec2(200, 0));
+    CHECKEQ(draw(), vector<vector<int>>({{0}, {1}, {2}, {3}}));
+    auto& frame = backend.getFrames().back();
+    CHECKEQ(frame.numSpriteBatches, 3);
+    CHECK(fabs(frame.overdraw - 3 * 24 * 24 / 1000000.0) < 1e-9);
+  }
+
   void testTextSerialization() {
     Tmp123 a1 {323, 'o', 43.1, "pok\" \\pak", 3.1415};
     Tmp456 a {'z', a1, 'n', '"', ' '};
@@ -957,6 +1409,26 @@ class Test {
     CHECK(a == b);
   }
 
+  void testContentIdDictionary() {
+    vector<FurnitureType> types {FurnitureType("TEST_DICT_A"), FurnitureType("TEST_DICT_B")};
+    for (int i : Range(100))
+      types.push_back(types[i % 2]);
+    std::stringstream stream;
+    {
+      OutputArchive archive(stream);
+      SerialDictionary dictionary(&archive);
+      archive(types);
+    }
+    CHECK(stream.str().size() < 300) << stream.str().size();
+    vector<FurnitureType> loaded;
+    {
+      InputArchive archive(stream);
+      SerialDictionary dictionary(&archive);
+      archive(loaded);
+    }
+    CHECK(loaded == types);
+  }
+
   void testPrettyInput() {
     map<string, TestStruct2> m;
     string text = "{"
@@ -1338,6 +1810,7 @@ void testAll() {
   Test().testMinionEquipmentLocking();
   Test().testEquipmentSlotLocking();
   Test().testMinionEquipment123();
+  Test().testActiveEffects();
   Test().testContainerRange();
   Test().testContainerRangeMap();
   Test().testContainerRangeErase();
@@ -1347,7 +1820,14 @@ void testAll() {
   Test().testContainerRangeMapConst();
   Test().testCacheTemplate();
   Test().testCacheTemplate2();
+  Test().testFlatHashContainers();
+  Test().testTableSerialization();
+  Test().testLayoutTile();
+  Test().testFrameArena();
+  Test().testLightEngine();
+  Test().testRenderCommandBatching();
   Test().testTextSerialization();
+  Test().testContentIdDictionary();
   Test().testPositionMatching1();
   Test().testPositionMatching2();
   Test().testPositionMatching3();
@@ -1377,8 +1857,14 @@ void testAll() {
   INFO << "-----===== OK =====-----";
 }
 
+void runBenchmarks() {
+  Test().benchmarkHashContainers();
+  Test().benchmarkActiveEffects();
+}
+
 #else
 void testAll() {}
+void runBenchmarks() {}
 
 #endif
 
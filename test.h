@@ -16,4 +16,6 @@
 #pragma once
 
 void testAll();
+// Timing comparisons that only log their results, so they are not part of testAll().
+void runBenchmarks();
 
@@ -7,3 +7,5 @@ class TileGasType : public ContentId<TileGasType> {
   public:
   using ContentId::ContentId;
 };
+
+CEREAL_CLASS_VERSION(TileGasType, 1)
@@ -5,14 +5,12 @@
 #include "pretty_archive.h"
 #include "layout_canvas.h"
 
-using Token = string;
-
 struct TilePredicate;
 
 namespace TilePredicates {
 
 struct On {
-  Token SERIAL(token);
+  LayoutToken SERIAL(token);
   SERIALIZE_ALL(roundBracket(), NAMED(token))
 };
 
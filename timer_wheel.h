@@ -0,0 +1,100 @@
+#pragma once
+
+#include "util.h"
+#include "game_time.h"
+
+// Hierarchical timing wheel. Values are returned by popExpired() once their deadline has passed,
+// and pending values cost nothing until then. A slot on level n covers 64^n turns, deadlines further
+// away than the last level are kept in an overflow list.
+// There is no explicit cancellation: callers should check if the value is still relevant when it expires.
+// Time can be GlobalTime or LocalTime.
+template <typename T, typename Time = GlobalTime>
+class TimerWheel {
+  public:
+  TimerWheel() : slots(numLevels * numSlots) {}
+
+  void add(Time deadline, T value) {
+    insert(Entry{deadline.getInternal(), std::move(value)});
+    ++count;
+  }
+
+  vector<T> popExpired(Time time) {
+    int now = time.getInternal();
+    if (count == 0 && now > currentTime)
+      currentTime = now;
+    while (currentTime < now) {
+      ++currentTime;
+      cascade();
+      append(expired, std::move(slots[getSlot(0, currentTime)]));
+      slots[getSlot(0, currentTime)].clear();
+    }
+    vector<T> ret;
+    for (auto& entry : expired)
+      ret.push_back(std::move(entry.value));
+    count -= expired.size();
+    expired.clear();
+    return ret;
+  }
+
+  int size() const {
+    return count;
+  }
+
+  template <class Archive>
+  void serialize(Archive& ar, const unsigned int) {
+    ar(currentTime, count, slots, overflow, expired);
+  }
+
+  private:
+  struct Entry {
+    int SERIAL(time);
+    T SERIAL(value);
+    SERIALIZE_ALL(time, value)
+  };
+
+  static constexpr int slotBits = 6;
+  static constexpr int numSlots = 1 << slotBits;
+  static constexpr int numLevels = 4;
+
+  static int getSlot(int level, int time) {
+    return level * numSlots + ((time >> (level * slotBits)) & (numSlots - 1));
+  }
+
+  void insert(Entry entry) {
+    int delta = entry.time - currentTime;
+    if (delta <= 0) {
+      expired.push_back(std::move(entry));
+      return;
+    }
+    for (int level : Range(numLevels))
+      if (delta < (1 << ((level + 1) * slotBits))) {
+        slots[getSlot(level, entry.time)].push_back(std::move(entry));
+        return;
+      }
+    overflow.push_back(std::move(entry));
+  }
+
+  // When a lower level wraps around, moves the entries of the next slot on the level above closer to the bottom.
+  void cascade() {
+    for (int level : Range(1, numLevels)) {
+      if (currentTime & ((1 << (level * slotBits)) - 1))
+        return;
+      auto entries = std::move(slots[getSlot(level, currentTime)]);
+      slots[getSlot(level, currentTime)].clear();
+      for (auto& entry : entries)
+        insert(std::move(entry));
+    }
+    if (!(currentTime & ((1 << (numLevels * slotBits)) - 1))) {
+      auto entries = std::move(overflow);
+      overflow.clear();
+      for (auto& entry : entries)
+        insert(std::move(entry));
+    }
+  }
+
+  int SERIAL(currentTime) = 0;
+  int SERIAL(count) = 0;
+  vector<vector<Entry>> SERIAL(slots);
+  vector<Entry> SERIAL(overflow);
+  vector<Entry> SERIAL(expired);
+};
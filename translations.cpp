@@ -84,20 +84,52 @@ vector<string> Translations::getTags(const string& language, const TString& s) c
   );
 }
 
+static constexpr int maxCacheSize = 20000;
+
 string Translations::get(const string& language, const TSentence& s, vector<string> form) const {
+  RecursiveLock lock(cacheMutex);
+  auto hash = combineHash(language, s, form);
+  auto it = cache.find(hash);
+  if (it != cache.end() && it->second.sentence == s && it->second.form == form && it->second.language == language) {
+    ++cacheStats.hits;
+    return it->second.text;
+  }
+  ++cacheStats.misses;
+  auto text = translate(language, s, form);
+  if (cache.size() >= maxCacheSize)
+    clearCache();
+  cache[hash] = CacheEntry{language, s, std::move(form), text};
+  return text;
+}
+
+void Translations::clearCache() const {
+  RecursiveLock lock(cacheMutex);
+  if (cacheStats.hits + cacheStats.misses > 0)
+    INFO << "Clearing translation cache, " << cache.size() << " entries, hit rate "
+        << 100.0 * cacheStats.hits / (cacheStats.hits + cacheStats.misses) << "%";
+  cache.clear();
+  cacheStats = CacheStats{};
+}
+
+Translations::CacheStats Translations::getCacheStats() const {
+  RecursiveLock lock(cacheMutex);
+  return cacheStats;
+}
+
+string Translations::translate(const string& language, const TSentence& s, vector<string> form) const {
   if (sentences) {
     if (!s.params.empty() && sentences->insert(make_pair(s.id, s)).second)
       std::cout << "Inserted " << s.id.data() << " " << s << std::endl;
   }
-  if (s.id == TStringId("CAPITAL_FIRST"))
+  if (s.id == STATIC_ID(TStringId, "CAPITAL_FIRST"))
     return capitalFirst(get(language, s.params[0], std::move(form)));
-  if (s.id == TStringId("MAKE_PLURAL")) {
+  if (s.id == STATIC_ID(TStringId, "MAKE_PLURAL")) {
     form.push_back("plural");
     return get(language, s.params[0], std::move(form));
   }
-  if (s.id == TStringId("MAKE_SENTENCE"))
+  if (s.id == STATIC_ID(TStringId, "MAKE_SENTENCE"))
     return makeSentence(get(language, s.params[0], std::move(form)));
-  if (s.id == TStringId("A_ARTICLE")) {
+  if (s.id == STATIC_ID(TStringId, "A_ARTICLE")) {
     auto res = get(language, s.params[0], std::move(form));
     if (language == "English" && !getTags(language, s.params[0]).contains("plural"))
       return addAParticle(res);
@@ -177,6 +209,7 @@ void Translations::setCurrentMods(vector<string> mods) {
 }
 
 void Translations::loadFromDir() {
+  clearCache();
   strings.clear();
   for (auto dir : currentDirs)
     for (auto file : dir.getFiles())
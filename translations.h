@@ -16,11 +16,18 @@ class Translations {
   string get(const string& language, const TString&, vector<string> form = {}) const;
   string get(const string& language, const TSentence&, vector<string> form = {}) const;
   vector<string> getLanguages() const;
+  struct CacheStats {
+    long long hits = 0;
+    long long misses = 0;
+  };
+  CacheStats getCacheStats() const;
 
   private:
 
   optional<string> addLanguage(string name, FilePath);
   vector<string> getTags(const string& language, const TString&) const;
+  string translate(const string& language, const TSentence&, vector<string> form) const;
+  void clearCache() const;
   struct TranslationInfo {
     string SERIAL(primary);
     vector<string> tags;
@@ -34,4 +41,14 @@ class Translations {
   DirectoryPath modsDir;
   vector<DirectoryPath> currentDirs;
   map<TStringId, TString>* sentences = nullptr;
+  // Translated sentences keyed by the hash of (language, sentence, form). Colliding entries replace each other.
+  struct CacheEntry {
+    string language;
+    TSentence sentence;
+    vector<string> form;
+    string text;
+  };
+  mutable HashMap<size_t, CacheEntry> cache;
+  mutable CacheStats cacheStats;
+  mutable recursive_mutex cacheMutex;
 };
\ No newline at end of file
@@ -89,6 +89,15 @@ bool RandomGen::chance(float v) {
   return getFloat(0, 1) <= v;
 }
 
+int RandomGen::getGeometric(double v) {
+  const double maxTrials = 1 << 30;
+  if (v >= 1)
+    return 1;
+  if (v <= 0)
+    return maxTrials;
+  return min(maxTrials, 1 + std::floor(std::log(1 - getDouble()) / std::log(1 - v)));
+}
+
 double RandomGen::getDouble() {
   return defaultDist(generator);
 }
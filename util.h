@@ -717,6 +717,9 @@ class RandomGen {
   bool roll(int chance);
   bool chance(double chance);
   bool chance(float chance);
+  // Number of trials until the first one that succeeds with the given chance, at least 1.
+  // Equivalent to calling chance() until it returns true, but costs a single roll.
+  int getGeometric(double chance);
   template <typename T>
   const T& choose(const vector<T>& v, const vector<double>& p) {
     CHECK(v.size() == p.size());
@@ -755,6 +758,11 @@ class RandomGen {
     return choose(v);
   }
 
+  template <typename T, typename Hash>
+  T choose(const FlatHashSet<T, Hash>& vi) {
+    return choose(vi.asVector());
+  }
+
   template <typename T>
   T choose(initializer_list<T> vi, initializer_list<double> pi) {
     return choose(vector<T>(vi), vector<double>(pi));
@@ -838,6 +846,11 @@ class RandomGen {
     return permutation(v);
   }
 
+  template <typename T, typename Hash>
+  vector<T> permutation(const FlatHashSet<T, Hash>& vi) {
+    return permutation(vi.asVector());
+  }
+
   template <typename T>
   vector<T> permutation(initializer_list<T> vi) {
     vector<T> v(vi);
@@ -989,11 +1002,18 @@ class Table {
     return mem[(vAbs.x - bounds.px) * bounds.h + vAbs.y - bounds.py];
   }
 
+  // Numbers and enums are written to binary archives as one block in the memory order, which is the same
+  // order in which the elements are serialized one by one. Since version 1 Table<bool> is packed to bits.
+  template <class Archive>
+  using IsBlockSerializable = std::integral_constant<bool,
+      (std::is_arithmetic<T>::value || std::is_enum<T>::value) &&
+      (std::is_same<Archive, cereal::BinaryOutputArchive>::value ||
+       std::is_same<Archive, cereal::BinaryInputArchive>::value)>;
+
   template <class Archive>
   void save(Archive& ar, const unsigned int version) const {
     ar << bounds;
-    for (Vec2 vAbs : bounds)
-      ar << mem[(vAbs.x - bounds.px) * bounds.h + vAbs.y - bounds.py];
+    saveElems(ar, IsBlockSerializable<Archive>());
   }
 
 #ifdef MEM_USAGE_TEST
@@ -1008,17 +1028,76 @@ class Table {
   void load(Archive& ar, const unsigned int version) {
     ar >> bounds;
     mem.reset(new T[bounds.width() * bounds.height()]);
-    for (Vec2 vAbs : bounds)
-      ar >> mem[(vAbs.x - bounds.px) * bounds.h + vAbs.y - bounds.py];
+    loadElems(ar, version, IsBlockSerializable<Archive>());
   }
 
   SERIALIZATION_CONSTRUCTOR(Table)
 
   private:
+  template <class Archive>
+  void saveElems(Archive& ar, std::false_type) const {
+    for (Vec2 vAbs : bounds)
+      ar << mem[(vAbs.x - bounds.px) * bounds.h + vAbs.y - bounds.py];
+  }
+
+  template <class Archive>
+  void loadElems(Archive& ar, const unsigned int, std::false_type) {
+    for (Vec2 vAbs : bounds)
+      ar >> mem[(vAbs.x - bounds.px) * bounds.h + vAbs.y - bounds.py];
+  }
+
+  template <class Archive, class U>
+  static void saveBlock(Archive& ar, const U* elems, int size) {
+    ar(cereal::binary_data(static_cast<const U*>(elems), sizeof(U) * size));
+  }
+
+  template <class Archive>
+  static void saveBlock(Archive& ar, const bool* elems, int size) {
+    vector<unsigned char> bits((size + 7) / 8, 0);
+    for (int i : Range(size))
+      if (elems[i])
+        bits[i / 8] |= (unsigned char) (1 << (i % 8));
+    ar(cereal::binary_data(bits.data(), bits.size()));
+  }
+
+  template <class Archive, class U>
+  static void loadBlock(Archive& ar, const unsigned int, U* elems, int size) {
+    ar(cereal::binary_data(elems, sizeof(U) * size));
+  }
+
+  template <class Archive>
+  static void loadBlock(Archive& ar, const unsigned int version, bool* elems, int size) {
+    static_assert(sizeof(bool) == 1, "Older saves have bools stored in single bytes");
+    if (version < 1) {
+      ar(cereal::binary_data(elems, size));
+      return;
+    }
+    vector<unsigned char> bits((size + 7) / 8);
+    ar(cereal::binary_data(bits.data(), bits.size()));
+    for (int i : Range(size))
+      elems[i] = (bits[i / 8] >> (i % 8)) & 1;
+  }
+
+  template <class Archive>
+  void saveElems(Archive& ar, std::true_type) const {
+    saveBlock(ar, mem.get(), bounds.w * bounds.h);
+  }
+
+  template <class Archive>
+  void loadElems(Archive& ar, const unsigned int version, std::true_type) {
+    loadBlock(ar, version, mem.get(), bounds.w * bounds.h);
+  }
+
   Rectangle bounds;
   unique_ptr<T[]> mem;
 };
 
+namespace cereal { namespace detail {
+  template <class T> struct Version<Table<T>> {
+    static const std::uint32_t version = 1;
+  };
+} }
+
 template<typename T>
 class DirtyTable {
   public:
@@ -1085,6 +1164,14 @@ vector<T> getKeys(const unordered_map<T, V, Hash>& m) {
   return ret;
 }
 
+template <typename T, typename V, typename Hash>
+vector<T> getKeys(const FlatHashMap<T, V, Hash>& m) {
+  vector<T> ret;
+  for (auto& elem : m)
+    ret.push_back(elem.first);
+  return ret;
+}
+
 template <typename T>
 T copyOf(const T& t) {
   return t;
@@ -180,6 +180,38 @@ const ViewObject* ViewIndex::getTopObject(const vector<ViewLayer>& layers) const
       return &getObject(layers[i]);
   return nullptr;
 }
+
+ViewIndex ViewIndex::withoutObjects() const {
+  ViewIndex ret;
+  ret.height = height;
+  ret.itemCounts = itemCounts;
+  ret.highlights = highlights;
+  ret.tileGas = tileGas;
+  ret.nightAmount = nightAmount;
+  ret.anyHighlight = anyHighlight;
+  ret.hiddenId = hiddenId;
+  return ret;
+}
+
+bool ViewIndex::operator == (const ViewIndex& o) const {
+  if (!!itemCounts != !!o.itemCounts || (itemCounts && *itemCounts != *o.itemCounts))
+    return false;
+  for (auto layer : ENUM_ALL(ViewLayer))
+    if (hasObject(layer) != o.hasObject(layer) || (hasObject(layer) && getObject(layer) != o.getObject(layer)))
+      return false;
+  return height == o.height && highlights == o.highlights && tileGas == o.tileGas &&
+      nightAmount == o.nightAmount && anyHighlight == o.anyHighlight;
+}
+
+size_t ViewIndex::getHash() const {
+  size_t objectsHash = 0;
+  for (auto layer : ENUM_ALL(ViewLayer))
+    if (hasObject(layer))
+      objectsHash = combineHash(objectsHash, getObject(layer));
+  return combineHash(objectsHash, highlights, tileGas, nightAmount, anyHighlight,
+      combineHashIter(getItemCounts().begin(), getItemCounts().end()));
+}
+
 void ViewIndex::setNightAmount(double amount) {
   nightAmount = (std::uint8_t) trunc(amount * 255);
 }
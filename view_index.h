@@ -72,6 +72,8 @@ class ViewIndex {
   bool isEmpty() const;
   bool noObjects() const;
   bool hasAnyHighlight() const;
+  // Copies everything but the objects.
+  ViewIndex withoutObjects() const;
   ~ViewIndex();
   // If the tile is not visible, we still need the id of the floor tile to render connections properly.
   optional<ViewId> getHiddenId() const;
@@ -90,6 +92,10 @@ class ViewIndex {
     Color SERIAL(color);
     TString SERIAL(name);
     SERIALIZE_ALL(color, name)
+    HASH_ALL(color, name)
+    bool operator == (const TileGasInfo& o) const {
+      return color == o.color && name == o.name;
+    }
   };
   const vector<TileGasInfo>& getGasAmounts() const;
 
@@ -98,6 +104,10 @@ class ViewIndex {
   ItemCounts& modItemCounts();
   ItemCounts& modEquipmentCounts();
 
+  // Compares the serialized members only, so height and hidden id are ignored.
+  bool operator == (const ViewIndex&) const;
+  size_t getHash() const;
+
   template <class Archive>
   void serialize(Archive& ar, const unsigned int version);
 
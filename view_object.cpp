@@ -24,6 +24,23 @@ SERIALIZATION_CONSTRUCTOR_IMPL(ViewObject);
 
 constexpr float noAttributeValue = -1234;
 
+bool ViewObject::operator == (const ViewObject& o) const {
+  return resource_id == o.resource_id && viewLayer == o.viewLayer && genericId == o.genericId &&
+      modifiers == o.modifiers && status == o.status && attributes == o.attributes &&
+      description == o.description && attachmentDir == o.attachmentDir &&
+      goodAdjectives == o.goodAdjectives && badAdjectives == o.badAdjectives &&
+      creatureAttributes == o.creatureAttributes && clickAction == o.clickAction &&
+      extendedActions == o.extendedActions;
+}
+
+bool ViewObject::operator != (const ViewObject& o) const {
+  return !(*this == o);
+}
+
+size_t ViewObject::getHash() const {
+  return combineHash(resource_id, viewLayer, genericId, modifiers, description, creatureAttributes);
+}
+
 ViewObject::ViewObject(ViewId id, ViewLayer l, const TString& d)
     : resource_id(id), viewLayer(l), description(capitalFirst(d)) {
   for (auto a : ENUM_ALL(Attribute))
@@ -41,6 +58,10 @@ void ViewObject::setGenericId(GenericId id) {
   genericId = id;
 }
 
+void ViewObject::resetGenericId() {
+  genericId = 0;
+}
+
 optional<GenericId> ViewObject::getGenericId() const {
   if (genericId)
     return genericId;
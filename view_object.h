@@ -81,6 +81,7 @@ class ViewObject {
   Vec2 getMovementInfo(int moveCounter) const;
 
   void setGenericId(GenericId);
+  void resetGenericId();
   optional<GenericId> getGenericId() const;
 
   void setClickAction(ViewObjectAction);
@@ -89,6 +90,11 @@ class ViewObject {
   const EnumSet<ViewObjectAction>& getExtendedActions() const;
   ViewIdList getViewIdList() const;
 
+  // Compares the serialized members only, so particle effects, part ids, weapon id and movement are ignored.
+  bool operator == (const ViewObject&) const;
+  bool operator != (const ViewObject&) const;
+  size_t getHash() const;
+
   SERIALIZATION_DECL(ViewObject)
 
   EnumSet<FXVariantName> particleEffects;
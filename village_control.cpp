@@ -113,6 +113,12 @@ bool VillageControl::canPillage(const Collective* by) const {
   return *canPillageCache;
 }
 
+EventSubscription VillageControl::getEventSubscription() {
+  using namespace EventInfo;
+  return {getEventMask<ItemStolen, ItemsAppeared, ItemsDropped, ItemsPillaged, ItemsPickedUp,
+      FurnitureRemoved>()};
+}
+
 void VillageControl::onEvent(const GameEvent& event) {
   using namespace EventInfo;
   event.visit<void>(
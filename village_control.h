@@ -29,6 +29,7 @@ class VillageControl : public CollectiveControl, public EventListener<VillageCon
   static PVillageControl copyOf(Collective* col, const VillageControl*);
 
   void onEvent(const GameEvent&);
+  static EventSubscription getEventSubscription();
 
   void updateAggression(EnemyAggressionLevel);
 
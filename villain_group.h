@@ -7,3 +7,5 @@ class VillainGroup : public ContentId<VillainGroup> {
   public:
   using ContentId::ContentId;
 };
+
+CEREAL_CLASS_VERSION(VillainGroup, 1)
@@ -45,12 +45,17 @@ void VisibilityMap::removeEyeball(Position pos) {
   eyeballs.erase(pos);
 }
 
-void VisibilityMap::onVisibilityChanged(Position pos) {
-  if (auto c = pos.getCreature())
-    if (lastUpdates.hasKey(c))
-      update(c, c->getVisibleTiles());
-  if (eyeballs.contains(pos))
-    updateEyeball(pos);
+void VisibilityMap::onVisibilityChanged(Level* level, const vector<SVec2>& positions) {
+  if (!eyeballs.containsLevel(level) && lastUpdates.empty())
+    return;
+  for (Vec2 v : positions) {
+    Position pos(v, level);
+    if (auto c = pos.getCreature())
+      if (lastUpdates.hasKey(c))
+        update(c, c->getVisibleTiles());
+    if (eyeballs.contains(pos))
+      updateEyeball(pos);
+  }
 }
 
 bool VisibilityMap::isVisible(Position pos) const {
@@ -14,7 +14,7 @@ class VisibilityMap {
   void remove(const Creature*);
   void updateEyeball(Position);
   void removeEyeball(Position);
-  void onVisibilityChanged(Position);
+  void onVisibilityChanged(Level*, const vector<SVec2>&);
   bool isVisible(Position) const;
 
   template <class Archive> 
@@ -34,6 +34,11 @@ class WarlordController : public Player, public EventListener<WarlordController>
       : Player(c, memory, messages, visibility, locations), team(team), originalTeam(originalTeam), teamOrders(orders) {
   }
 
+  static EventSubscription getEventSubscription() {
+    using namespace EventInfo;
+    return {getEventMask<CreatureKilled>(), true};
+  }
+
   void onEvent(const GameEvent& event) {
     using namespace EventInfo;
     event.visit<void>(
@@ -296,6 +296,10 @@ void WindowView::rebuildMinimapGui() {
 
 void WindowView::rebuildGui() {
   INFO << "Rebuilding UI";
+  auto startTime = Clock::getRealMicros();
+  tempGuiElems.clear();
+  guiArena.startFrame();
+  FrameArena::Scope arenaScope(&guiArena);
   rebuildMinimapGui();
   mapGui->setBounds(getMapGuiBounds());
   SGuiElem bottom, right;
@@ -305,7 +309,6 @@ void WindowView::rebuildGui() {
   optional<int> topBarHeight;
   int rightBottomMargin = 30;
   optional<Rectangle> bottomBarBounds;
-  tempGuiElems.clear();
   if (!options->getIntValue(OptionId::DISABLE_MOUSE_WHEEL)) {
     tempGuiElems.push_back(gui.mouseWheel([this](bool up) {
       if (renderer.isKeypressed(SDL::SDL_SCANCODE_LCTRL))
@@ -422,6 +425,10 @@ void WindowView::rebuildGui() {
   }, {gui.getKey(C_BUILDINGS_CONFIRM)}));
   tempGuiElems.back()->setBounds(getMapGuiBounds());
   propagateMousePosition(getClickableGuiElems());
+  auto stats = guiArena.getStats();
+  INFO << "UI rebuilt in " << (Clock::getRealMicros() - startTime).count() << " us, " << stats.numAllocations
+      << " elements allocated in the frame arena (" << stats.numBytes << " bytes), " << stats.numChunks
+      << " chunks, " << stats.numPinnedChunks << " pinned";
 }
 
 Vec2 WindowView::getOverlayPosition(GuiBuilder::OverlayInfo::Alignment alignment, int height, int width,
@@ -1094,6 +1101,8 @@ void WindowView::propagateEvent(const Event& event, vector<SGuiElem> guiElems) {
 
 // These commands will run even in blocking gui.
 void WindowView::keyboardActionAlways(const SDL_Keysym& key) {
+  if (key.sym == SDL::SDLK_F7 && (debugOptions || Profiler::isHotkeyEnabled()))
+    Profiler::toggle();
   if (debugOptions)
     switch (key.sym) {
       case SDL::SDLK_F8:
@@ -137,6 +137,8 @@ class WindowView: public View {
   shared_ptr<MinimapGui> minimapGui;
   SGuiElem mapDecoration;
   SGuiElem minimapDecoration;
+  // Holds the elements made by rebuildGui(), which are thrown away by the next rebuild.
+  FrameArena guiArena;
   vector<SGuiElem> tempGuiElems;
   vector<SGuiElem> blockingElems;
   vector<SGuiElem> getAllGuiElems();
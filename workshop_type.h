@@ -8,3 +8,5 @@ class WorkshopType : public ContentId<WorkshopType> {
   using ContentId::ContentId;
 };
 
+
+CEREAL_CLASS_VERSION(WorkshopType, 1)
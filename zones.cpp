@@ -8,7 +8,18 @@
 #include "level.h"
 #include "shortest_path.h"
 
-SERIALIZE_DEF(Zones, positions, zones, quarters, quartersSectors)
+template <class Archive>
+void Zones::serialize(Archive& ar, const unsigned int version) {
+  if (Archive::is_loading::value && version == 0) {
+    EnumMap<ZoneId, PositionSet> oldPositions;
+    ar(oldPositions, zones, quarters, quartersSectors);
+    for (auto id : ENUM_ALL(ZoneId))
+      positions[id] = DensePositionSet(oldPositions[id]);
+  } else
+    ar(positions, zones, quarters, quartersSectors);
+}
+
+SERIALIZABLE(Zones)
 SERIALIZATION_CONSTRUCTOR_IMPL(Zones)
 
 template <typename T, typename Compare>
@@ -58,7 +69,7 @@ void Zones::eraseZone(Position pos, ZoneId id) {
   }
 }
 
-const PositionSet& Zones::getPositions(ZoneId id) const {
+const DensePositionSet& Zones::getPositions(ZoneId id) const {
   return positions[id];
 }
 
@@ -110,7 +121,7 @@ bool Zones::canSet(Position pos, ZoneId id, const Collective* col) const {
 
 void Zones::tick() {
   PROFILE_BLOCK("Zones::tick");
-  for (auto pos : copyOf(positions[ZoneId::FETCH_ITEMS]))
+  for (auto pos : positions[ZoneId::FETCH_ITEMS].asVector())
     if (pos.getItems().empty())
       eraseZone(pos, ZoneId::FETCH_ITEMS);
 }
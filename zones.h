@@ -6,6 +6,7 @@
 #include "unique_entity.h"
 #include "entity_map.h"
 #include "sectors.h"
+#include "dense_position_set.h"
 
 RICH_ENUM(ZoneId,
   FETCH_ITEMS,
@@ -30,7 +31,7 @@ class Zones {
   bool isAnyZone(Position, EnumSet<ZoneId>) const;
   void setZone(Position, ZoneId);
   void eraseZone(Position, ZoneId);
-  const PositionSet& getPositions(ZoneId) const;
+  const DensePositionSet& getPositions(ZoneId) const;
   void setHighlights(Position, ViewIndex&) const;
   bool canSet(Position, ZoneId, const Collective*) const;
   void tick();
@@ -59,8 +60,10 @@ class Zones {
   const PositionSet& getQuartersPositions(Level* level, Sectors::SectorId id) const;
   unordered_map<Level*, Sectors> SERIAL(quartersSectors);
   BiMap<UniqueEntity<Creature>::Id, pair<Level*, Sectors::SectorId>> SERIAL(quarters);
-  EnumMap<ZoneId, PositionSet> SERIAL(positions);
+  EnumMap<ZoneId, DensePositionSet> SERIAL(positions);
   PositionMap<EnumSet<ZoneId>> SERIAL(zones);
   mutable HashMap<pair<Level*, Sectors::SectorId>, PositionSet> quartersPositionCache;
   Sectors& getOrInitSectors(Level*);
 };
+
+CEREAL_CLASS_VERSION(Zones, 1)